@@ -14,11 +14,16 @@ pybind11_add_module(_sealapi_cpp ${SEALAPI_SOURCES})
 
 set(SOURCES
     ${TENSEAL_BASEDIR}/cpp/context/tensealcontext.cpp
+    ${TENSEAL_BASEDIR}/cpp/context/encode_cache.cpp
+    ${TENSEAL_BASEDIR}/cpp/context/galois_key_store.cpp
+    ${TENSEAL_BASEDIR}/cpp/context/registry.cpp
     ${TENSEAL_BASEDIR}/cpp/context/sealcontext.cpp
     ${TENSEAL_BASEDIR}/cpp/tensors/bfvvector.cpp
     ${TENSEAL_BASEDIR}/cpp/tensors/bfvtensor.cpp
     ${TENSEAL_BASEDIR}/cpp/tensors/ckkstensor.cpp
     ${TENSEAL_BASEDIR}/cpp/tensors/ckksvector.cpp
+    ${TENSEAL_BASEDIR}/cpp/tensors/encoded_matrix.cpp
+    ${TENSEAL_BASEDIR}/cpp/tensors/utils/rotation_planner.cpp
     ${TENSEAL_BASEDIR}/cpp/tensors/utils/utils.cpp)
 
 add_library(tenseal SHARED ${SOURCES})
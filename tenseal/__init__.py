@@ -1,13 +1,17 @@
 """TenSEAL is a library for doing homomorphic encryption operation on tensors.
 """
 
+from typing import List, Union
+
 try:
     import _tenseal_cpp as _ts_cpp
 except ImportError:
     import tenseal._tenseal_cpp as _ts_cpp
-from tenseal.tensors import CKKSTensor, CKKSVector, BFVVector, BFVTensor, PlainTensor
+from tenseal.tensors import CKKSTensor, CKKSVector, BFVVector, BFVTensor, PlainTensor, EncodedMatrix
 
 from tenseal.enc_context import Context, SCHEME_TYPE, ENCRYPTION_TYPE
+from tenseal.cancellation import CancellationToken, OperationCancelled
+from tenseal.rotation_planner import RotationPlanner
 from tenseal.version import __version__
 
 
@@ -113,6 +117,11 @@ def lazy_ckks_vector_from(data: bytes) -> CKKSVector:
     return CKKSVector.lazy_load(data)
 
 
+def encoded_matrix(*args, **kwargs) -> EncodedMatrix:
+    """Constructor function for tenseal.EncodedMatrix"""
+    return EncodedMatrix(*args, **kwargs)
+
+
 def ckks_tensor(*args, **kwargs) -> CKKSTensor:
     """Constructor function for tenseal.CKKSTensor"""
     return CKKSTensor(*args, **kwargs)
@@ -145,6 +154,47 @@ def lazy_bfv_tensor_from(data: bytes) -> BFVTensor:
     return BFVTensor.lazy_load(data)
 
 
+def select_ckks_parameters(
+    depth: int, precision_bits: int, vector_size: int, security_level: int = 128
+) -> dict:
+    """Select the cheapest CKKS parameters able to run a computation.
+
+    Args:
+        depth: the multiplicative depth of the computation. mul, mul_plain, dot, matmul
+            and conv2d_im2col consume one level each, see polyval_depth for polyval.
+        precision_bits: the bits of precision needed after the binary point.
+        vector_size: the maximum number of values in a vector.
+        security_level: the security level in bits, 128, 192 or 256.
+
+    Returns:
+        A dict with the poly_modulus_degree, coeff_mod_bit_sizes and global_scale to use.
+    """
+    return _ts_cpp.select_ckks_parameters(depth, precision_bits, vector_size, security_level)
+
+
+def select_bfv_parameters(
+    depth: int, plain_modulus_bits: int, vector_size: int, security_level: int = 128
+) -> dict:
+    """Select the cheapest BFV parameters able to run a computation.
+
+    Args:
+        depth: the number of successive ciphertext multiplications.
+        plain_modulus_bits: the bit size of the plaintext modulus.
+        vector_size: the maximum number of values in a vector.
+        security_level: the security level in bits, 128, 192 or 256.
+
+    Returns:
+        A dict with the poly_modulus_degree, plain_modulus and coeff_mod_bit_sizes to use.
+    """
+    return _ts_cpp.select_bfv_parameters(depth, plain_modulus_bits, vector_size, security_level)
+
+
+def polyval_depth(degree: Union[int, List[float]]) -> int:
+    """Multiplicative depth consumed by polyval for a polynomial of a given degree, or for
+    the given coefficients, whose terms with a coefficient of 1.0 consume one level less."""
+    return _ts_cpp.polyval_depth(degree)
+
+
 __all__ = [
     "bfv_vector",
     "bfv_vector_from",
@@ -152,6 +202,7 @@ __all__ = [
     "ckks_vector",
     "ckks_vector_from",
     "lazy_ckks_vector_from",
+    "encoded_matrix",
     "ckks_tensor",
     "ckks_tensor_from",
     "lazy_ckks_tensor_from",
@@ -163,7 +214,13 @@ __all__ = [
     "im2col_encoding",
     "plain_tensor",
     "plain_tensor_from",
+    "select_ckks_parameters",
+    "select_bfv_parameters",
+    "polyval_depth",
     "ENCRYPTION_TYPE",
     "SCHEME_TYPE",
+    "CancellationToken",
+    "OperationCancelled",
+    "RotationPlanner",
     "__version__",
 ]
@@ -1,4 +1,5 @@
 #include <pybind11/iostream.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -14,6 +15,34 @@ using namespace std;
 using namespace seal::util;
 namespace py = pybind11;
 
+/**
+ * Guard of the long running operations which don't modify the tensor: the
+ *GIL is released while they run, so the other Python threads progress, and
+ *can cancel them. Like for numpy, a tensor must not be modified by another
+ *thread while it's read.
+ **/
+using release_gil = py::call_guard<py::gil_scoped_release>;
+
+sec_level_type security_level(int bits) {
+    switch (bits) {
+        case 128:
+            return sec_level_type::tc128;
+        case 192:
+            return sec_level_type::tc192;
+        case 256:
+            return sec_level_type::tc256;
+        default:
+            throw invalid_argument(
+                "the security level must be 128, 192 or 256 bits");
+    }
+}
+
+vector<int> coeff_mod_bit_sizes(const EncryptionParameters &parms) {
+    vector<int> bit_sizes;
+    for (const auto &modulus : parms.coeff_modulus())
+        bit_sizes.push_back(modulus.bit_count());
+    return bit_sizes;
+}
 
 void bind_globals(py::module &m) {
     py::enum_<encryption_type>(m, "ENCRYPTION_TYPE")
@@ -21,6 +50,85 @@ void bind_globals(py::module &m) {
         .value("SYMMETRIC", encryption_type::symmetric);
 }
 
+void bind_cancellation(py::module &m) {
+    using sync::cancellation_token;
+
+    py::register_exception<sync::operation_cancelled>(m, "OperationCancelled",
+                                                      PyExc_RuntimeError);
+
+    py::class_<cancellation_token>(m, "CancellationToken", py::module_local())
+        .def(py::init<>())
+        .def("cancel", &cancellation_token::cancel)
+        .def("cancelled", &cancellation_token::cancelled)
+        .def(
+            "timeout",
+            [](cancellation_token &obj, double seconds) {
+                obj.deadline(cancellation_token::clock::now() +
+                             std::chrono::duration_cast<
+                                 cancellation_token::clock::duration>(
+                                 std::chrono::duration<double>(seconds)));
+            },
+            R"(Cancel the operations observing the token after a number of seconds.)",
+            py::arg("seconds"))
+        .def_static("exchange_current",
+                    &cancellation_token::exchange_current,
+                    R"(Install a token on the calling thread, returning the previous one.)",
+                    py::arg("token"));
+}
+
+void bind_metrics(py::module &m) {
+    using sync::latency_histogram;
+    using sync::ThreadPoolMetrics;
+
+    py::class_<latency_histogram>(m, "LatencyHistogram", py::module_local())
+        .def_readonly("buckets", &latency_histogram::buckets)
+        .def("count", &latency_histogram::count)
+        .def("quantile", &latency_histogram::quantile,
+             "Upper bound, in microseconds, of the q-quantile",
+             py::arg("q"));
+
+    py::class_<ThreadPoolMetrics>(m, "ThreadPoolMetrics", py::module_local())
+        .def_readonly("queue_depth", &ThreadPoolMetrics::queue_depth)
+        .def_readonly("shared_queue_depth",
+                      &ThreadPoolMetrics::shared_queue_depth)
+        .def_readonly("tasks_executed", &ThreadPoolMetrics::tasks_executed)
+        .def_readonly("helper_tasks_executed",
+                      &ThreadPoolMetrics::helper_tasks_executed)
+        .def_readonly("busy_time", &ThreadPoolMetrics::busy_time)
+        .def_readonly("idle_time", &ThreadPoolMetrics::idle_time)
+        .def_readonly("task_duration", &ThreadPoolMetrics::task_duration)
+        .def_readonly("queue_delay", &ThreadPoolMetrics::queue_delay);
+
+    py::class_<EncodeCacheStats>(m, "EncodeCacheStats", py::module_local())
+        .def_readonly("hits", &EncodeCacheStats::hits)
+        .def_readonly("misses", &EncodeCacheStats::misses)
+        .def_readonly("size", &EncodeCacheStats::size)
+        .def_readonly("capacity", &EncodeCacheStats::capacity);
+}
+
+void bind_rotation_planner(py::module &m) {
+    auto chained = py::return_value_policy::reference_internal;
+
+    py::class_<RotationPlanner>(m, "RotationPlanner", py::module_local())
+        .def(py::init<shared_ptr<TenSEALContext>>(), py::arg("context"))
+        .def("sum", &RotationPlanner::sum, chained, py::arg("size"))
+        .def("dot", &RotationPlanner::dot, chained, py::arg("size"))
+        .def("matmul_plain", &RotationPlanner::matmul_plain, chained,
+             py::arg("rows"), py::arg("cols"))
+        .def("enc_matmul_plain", &RotationPlanner::enc_matmul_plain, chained,
+             py::arg("plain_size"), py::arg("rows_nb"))
+        .def("conv2d_im2col", &RotationPlanner::conv2d_im2col, chained,
+             py::arg("kernel_rows"), py::arg("kernel_cols"),
+             py::arg("windows_nb"))
+        .def("replicate_first_slot", &RotationPlanner::replicate_first_slot,
+             chained, py::arg("n"))
+        .def("rotate", &RotationPlanner::rotate, chained, py::arg("step"))
+        .def("steps", &RotationPlanner::steps)
+        .def("galois_elts", &RotationPlanner::galois_elts)
+        .def("generate_galois_keys", &RotationPlanner::generate_galois_keys,
+             py::call_guard<py::gil_scoped_release>());
+}
+
 void bind_sealapi(py::module &m) {
     // SEAL API
     bind_seal_encrypt_decrypt(m);
@@ -53,6 +161,20 @@ void bind_context(py::module &m) {
             "auto_mod_switch",
             py::overload_cast<>(&TenSEALContext::auto_mod_switch, py::const_),
             py::overload_cast<bool>(&TenSEALContext::auto_mod_switch))
+        .def_property(
+            "lazy_galois_keys",
+            py::overload_cast<>(&TenSEALContext::lazy_galois_keys, py::const_),
+            py::overload_cast<bool>(&TenSEALContext::lazy_galois_keys))
+        .def_property(
+            "encode_cache_capacity",
+            py::overload_cast<>(&TenSEALContext::encode_cache_capacity,
+                                py::const_),
+            py::overload_cast<size_t>(&TenSEALContext::encode_cache_capacity))
+        .def_property(
+            "resident_galois_keys",
+            py::overload_cast<>(&TenSEALContext::resident_galois_keys,
+                                py::const_),
+            py::overload_cast<size_t>(&TenSEALContext::resident_galois_keys))
         .def("new",
              py::overload_cast<scheme_type, size_t, uint64_t, vector<int>,
                                encryption_type, optional<size_t>>(
@@ -76,7 +198,8 @@ void bind_context(py::module &m) {
         .def("has_secret_key", &TenSEALContext::has_secret_key)
         .def("relin_keys", &TenSEALContext::relin_keys)
         .def("has_relin_keys", &TenSEALContext::has_relin_keys)
-        .def("galois_keys", &TenSEALContext::galois_keys)
+        .def("galois_keys",
+             py::overload_cast<>(&TenSEALContext::galois_keys, py::const_))
         .def("has_galois_keys", &TenSEALContext::has_galois_key)
         .def("is_public", &TenSEALContext::is_public)
         .def("is_private", &TenSEALContext::is_private)
@@ -92,6 +215,23 @@ void bind_context(py::module &m) {
              py::overload_cast<const SecretKey &>(
                  &TenSEALContext::generate_galois_keys),
              "Generate Galois keys using the secret key")
+        .def("generate_galois_keys",
+             py::overload_cast<const vector<int> &>(
+                 &TenSEALContext::generate_galois_keys),
+             "Generate Galois keys for a set of rotation steps only",
+             py::arg("steps"))
+        .def("generate_galois_keys",
+             py::overload_cast<const SecretKey &, const vector<int> &>(
+                 &TenSEALContext::generate_galois_keys),
+             "Generate Galois keys for a set of rotation steps only",
+             py::arg("secret_key"), py::arg("steps"))
+        .def("store_galois_keys", &TenSEALContext::store_galois_keys,
+             "Move the Galois keys to a key store file, loaded per rotation "
+             "step on first use",
+             py::arg("path"))
+        .def("load_galois_keys", &TenSEALContext::load_galois_keys,
+             "Use the Galois keys of an existing key store file",
+             py::arg("path"))
         .def("generate_relin_keys",
              py::overload_cast<>(&TenSEALContext::generate_relin_keys),
              "Generate Relinearization keys using the secret key")
@@ -110,6 +250,60 @@ void bind_context(py::module &m) {
                     py::overload_cast<const std::string &, optional<size_t>>(
                         &TenSEALContext::Create),
                     py::arg("buffer"), py::arg("n_threads") = get_concurrency())
+        .def(
+            "dispatcher_cpus",
+            [](TenSEALContext &obj, const vector<unsigned int> &cpus,
+               bool pin_to_core) {
+                obj.dispatcher_affinity(
+                    sync::ThreadAffinity{cpus, pin_to_core});
+            },
+            "Pin the dispatcher workers to a set of CPUs", py::arg("cpus"),
+            py::arg("pin_to_core") = true)
+        .def(
+            "dispatcher_numa_node",
+            [](TenSEALContext &obj, unsigned int node) {
+                obj.dispatcher_affinity(sync::numa_node_affinity(node));
+            },
+            "Keep the dispatcher workers on the CPUs of a NUMA node")
+        .def("dispatcher_memory_usage",
+             &TenSEALContext::dispatcher_memory_usage,
+             "Bytes allocated by the memory pool of each dispatcher worker")
+        .def("dispatcher_metrics", &TenSEALContext::dispatcher_metrics,
+             "Queue depths, task counters and latency histograms of the "
+             "dispatcher")
+        .def("encode_cache_stats", &TenSEALContext::encode_cache_stats,
+             "Hit and miss counters of the encode cache")
+        .def("clear_encode_cache", &TenSEALContext::clear_encode_cache,
+             "Release the plaintexts of the encode cache")
+        .def_static(
+            "use_shared_dispatcher",
+            py::overload_cast<bool>(&TenSEALContext::use_shared_dispatcher),
+            "Switch on/off the use of a process-wide threadpool by the "
+            "contexts")
+        .def_static(
+            "use_shared_dispatcher",
+            py::overload_cast<>(&TenSEALContext::use_shared_dispatcher))
+        .def_static(
+            "use_context_registry",
+            py::overload_cast<bool>(&TenSEALContext::use_context_registry),
+            "Switch on/off the interning of the SEALContext and the public "
+            "keys of the contexts")
+        .def_static(
+            "use_context_registry",
+            py::overload_cast<>(&TenSEALContext::use_context_registry))
+        .def_static("clear_context_registry",
+                    &TenSEALContext::clear_context_registry)
+        .def_static("context_registry_capacity",
+                    py::overload_cast<size_t>(
+                        &TenSEALContext::context_registry_capacity),
+                    "Set the number of released SEALContexts and keys kept "
+                    "for the next contexts")
+        .def_static("context_registry_capacity",
+                    py::overload_cast<>(
+                        &TenSEALContext::context_registry_capacity))
+        .def("fingerprint", &TenSEALContext::fingerprint,
+             "Digest of the parameters, flags, scale and keys of the context")
+        .def("equals", &TenSEALContext::equals)
         .def("copy", &TenSEALContext::copy)
         .def("__copy__",
              [](const std::shared_ptr<TenSEALContext> &self) {
@@ -163,16 +357,22 @@ void bind_context(py::module &m) {
                                    std::vector<uint64_t>,
                                    std::vector<uint64_t>>> result;
 
-          const auto& gk_ptr = ctx->galois_keys();
-          if (!gk_ptr) return result;
-          const GaloisKeys& gk = *gk_ptr;
-
           const SEALContext& seal_ctx = *ctx->seal_context();
           auto key_context_data = seal_ctx.key_context_data();
           auto parms = key_context_data->parms();
           size_t poly_modulus_degree = parms.poly_modulus_degree();
           size_t coeff_modulus_size = parms.coeff_modulus().size();
 
+          // only the requested keys are loaded from a key store
+          std::vector<uint32_t> elts;
+          for (int elt : autoIdx_list)
+               if (elt > 0 && elt % 2 == 1 &&
+                   static_cast<size_t>(elt) < 2 * poly_modulus_degree)
+                    elts.push_back(static_cast<uint32_t>(elt));
+          const auto& gk_ptr = ctx->galois_elt_keys(elts);
+          if (!gk_ptr) return result;
+          const GaloisKeys& gk = *gk_ptr;
+
           //     auto galois_tool = GaloisTool::initialize(poly_modulus_degree);
 
           for (int galois_element : autoIdx_list) {
@@ -210,6 +410,116 @@ void bind_context(py::module &m) {
 
 }
 
+/**
+ * Bind the future returned by the asynchronous operations of an encrypted
+ *tensor, the GIL is released while waiting for the result.
+ **/
+template <typename T>
+void bind_tensor_future(py::module &m, const std::string &name) {
+    using type = std::shared_future<shared_ptr<T>>;
+    std::string class_name = name + "Future";
+
+    py::class_<type>(m, class_name.c_str(), py::module_local())
+        .def("result", [](const type &obj) { return obj.get(); },
+             py::call_guard<py::gil_scoped_release>())
+        .def("done", [](const type &obj) {
+            return obj.wait_for(std::chrono::seconds(0)) ==
+                   std::future_status::ready;
+        });
+}
+
+/**
+ * Bind the *_async operations of an already bound encrypted tensor.
+ **/
+template <typename T, typename plain_t>
+void bind_async_ops(py::module &m, const std::string &name) {
+    using enc_t = shared_ptr<T>;
+    bind_tensor_future<T>(m, name);
+
+    py::reinterpret_borrow<py::class_<T, enc_t>>(m.attr(name.c_str()))
+        .def("neg_async", [](enc_t obj) { return obj->negate_async().share(); })
+        .def("square_async",
+             [](enc_t obj) { return obj->square_async().share(); })
+        .def("pow_async",
+             [](enc_t obj, unsigned int power) {
+                 return obj->power_async(power).share();
+             })
+        .def(
+            "sum_async",
+            [](enc_t obj, size_t axis) { return obj->sum_async(axis).share(); },
+            py::arg("axis") = 0)
+        .def("polyval_async",
+             [](enc_t obj, const vector<plain_t> &coefficients) {
+                 return obj->polyval_async(coefficients).share();
+             })
+        .def("add_async",
+             [](enc_t obj, const enc_t &other) {
+                 return obj->add_async(other).share();
+             })
+        .def("add_async",
+             [](enc_t obj, const plain_t &other) {
+                 return obj->add_plain_async(other).share();
+             })
+        .def("add_async",
+             [](enc_t obj, const PlainTensor<plain_t> &other) {
+                 return obj->add_plain_async(other).share();
+             })
+        .def("add_async",
+             [](enc_t obj, const vector<plain_t> &other) {
+                 return obj->add_plain_async(PlainTensor<plain_t>(other))
+                     .share();
+             })
+        .def("sub_async",
+             [](enc_t obj, const enc_t &other) {
+                 return obj->sub_async(other).share();
+             })
+        .def("sub_async",
+             [](enc_t obj, const plain_t &other) {
+                 return obj->sub_plain_async(other).share();
+             })
+        .def("sub_async",
+             [](enc_t obj, const PlainTensor<plain_t> &other) {
+                 return obj->sub_plain_async(other).share();
+             })
+        .def("sub_async",
+             [](enc_t obj, const vector<plain_t> &other) {
+                 return obj->sub_plain_async(PlainTensor<plain_t>(other))
+                     .share();
+             })
+        .def("mul_async",
+             [](enc_t obj, const enc_t &other) {
+                 return obj->mul_async(other).share();
+             })
+        .def("mul_async",
+             [](enc_t obj, const plain_t &other) {
+                 return obj->mul_plain_async(other).share();
+             })
+        .def("mul_async",
+             [](enc_t obj, const PlainTensor<plain_t> &other) {
+                 return obj->mul_plain_async(other).share();
+             })
+        .def("mul_async",
+             [](enc_t obj, const vector<plain_t> &other) {
+                 return obj->mul_plain_async(PlainTensor<plain_t>(other))
+                     .share();
+             })
+        .def("dot_async",
+             [](enc_t obj, const enc_t &other) {
+                 return obj->dot_async(other).share();
+             })
+        .def("dot_async",
+             [](enc_t obj, const PlainTensor<plain_t> &other) {
+                 return obj->dot_plain_async(other).share();
+             })
+        .def("mm_async",
+             [](enc_t obj, const enc_t &other) {
+                 return obj->matmul_async(other).share();
+             })
+        .def("mm_async", [](enc_t obj, const PlainTensor<plain_t> &other) {
+            return obj->matmul_plain_async(other).share();
+        });
+}
+
 template <typename plain_t>
 void bind_plain_tensor(py::module &m, const std::string &name) {
     using type = PlainTensor<plain_t>;
@@ -250,6 +560,29 @@ void bind_bfv_vector(py::module &m) {
         coeff_mod_bit_sizes : List of bit size for each coeffecient modulus.)",
           py::arg("poly_modulus_degree"), py::arg("plain_modulus"),
           py::arg("coeff_mod_bit_sizes") = vector<int>());
+    m.def(
+        "select_bfv_parameters",
+        [](size_t depth, int plain_modulus_bits, size_t vector_size,
+           int security_bits) {
+            auto parms =
+                select_bfv_parameters(depth, plain_modulus_bits, vector_size,
+                                      security_level(security_bits));
+            py::dict result;
+            result["poly_modulus_degree"] = parms.poly_modulus_degree();
+            result["plain_modulus"] = parms.plain_modulus().value();
+            result["coeff_mod_bit_sizes"] = coeff_mod_bit_sizes(parms);
+            return result;
+        },
+        R"(Select the cheapest BFV parameters for a workload.
+    Args:
+        depth : The number of successive ciphertext multiplications.
+        plain_modulus_bits : The bit size of the plaintext modulus.
+        vector_size : The maximum number of values in a vector.
+        security_level : The security level in bits, 128, 192 or 256.
+    Returns:
+        A dict with the poly_modulus_degree, plain_modulus and coeff_mod_bit_sizes.)",
+        py::arg("depth"), py::arg("plain_modulus_bits"), py::arg("vector_size"),
+        py::arg("security_level") = 128);
 
     py::class_<BFVVector, std::shared_ptr<BFVVector>>(m, "BFVVector",
                                                       py::module_local())
@@ -313,13 +646,13 @@ void bind_bfv_vector(py::module &m) {
              })
         .def("mul_plain_",
              py::overload_cast<const int64_t &>(&BFVVector::mul_plain_inplace))
-        .def("polyval", &BFVVector::polyval)
+        .def("polyval", &BFVVector::polyval, release_gil())
         .def("polyval_", &BFVVector::polyval_inplace)
-        .def("dot", &BFVVector::dot)
-        .def("dot", &BFVVector::dot_plain)
+        .def("dot", &BFVVector::dot, release_gil())
+        .def("dot", &BFVVector::dot_plain, release_gil())
         .def("dot_", &BFVVector::dot_inplace)
         .def("dot_", &BFVVector::dot_plain_inplace)
-        .def("sum", &BFVVector::sum, py::arg("axis") = 0)
+        .def("sum", &BFVVector::sum, release_gil(), py::arg("axis") = 0)
         .def("sum_", &BFVVector::sum_inplace, py::arg("axis") = 0)
         // python arithmetic
         .def("__add__", &BFVVector::add)
@@ -384,9 +717,71 @@ void bind_ckks_vector(py::module &m) {
         poly_modulus_degree : The degree of the polynomial modulus, must be a power of two.
         coeff_mod_bit_sizes : List of bit size for each coeffecient modulus.)",
           py::arg("poly_modulus_degree"), py::arg("coeff_mod_bit_sizes"));
+    m.def(
+        "select_ckks_parameters",
+        [](size_t depth, int precision_bits, size_t vector_size,
+           int security_bits) {
+            auto [parms, scale] =
+                select_ckks_parameters(depth, precision_bits, vector_size,
+                                       security_level(security_bits));
+            py::dict result;
+            result["poly_modulus_degree"] = parms.poly_modulus_degree();
+            result["coeff_mod_bit_sizes"] = coeff_mod_bit_sizes(parms);
+            result["global_scale"] = scale;
+            return result;
+        },
+        R"(Select the cheapest CKKS parameters for a workload.
+    Args:
+        depth : The multiplicative depth of the computation, see polyval_depth.
+        precision_bits : The bits of precision after the binary point.
+        vector_size : The maximum number of values in a vector.
+        security_level : The security level in bits, 128, 192 or 256.
+    Returns:
+        A dict with the poly_modulus_degree, coeff_mod_bit_sizes and global_scale.)",
+        py::arg("depth"), py::arg("precision_bits"), py::arg("vector_size"),
+        py::arg("security_level") = 128);
+    m.def("polyval_depth", py::overload_cast<size_t>(&polyval_depth),
+          R"(Multiplicative depth consumed by polyval for a polynomial of a given degree.)",
+          py::arg("degree"));
+    m.def("polyval_depth",
+          py::overload_cast<const vector<double> &>(&polyval_depth),
+          R"(Multiplicative depth consumed by polyval for the given coefficients.)",
+          py::arg("coefficients"));
+
+    py::class_<EncodedMatrix, std::shared_ptr<EncodedMatrix>>(
+        m, "EncodedMatrix", py::module_local())
+        .def(py::init([](const shared_ptr<TenSEALContext> &ctx,
+                         const PlainTensor<double> &matrix,
+                         std::optional<double> scale) {
+                 return EncodedMatrix::Create(ctx, matrix, scale);
+             }),
+             py::arg("context"), py::arg("matrix"),
+             py::arg("scale") = py::none())
+        .def("shape", &EncodedMatrix::shape)
+        .def("scale", &EncodedMatrix::scale)
+        .def("indices", &EncodedMatrix::indices)
+        .def("baby_steps", &EncodedMatrix::baby_steps)
+        .def("clear", &EncodedMatrix::clear)
+        .def("context", &EncodedMatrix::tenseal_context);
 
     py::class_<CKKSVector, std::shared_ptr<CKKSVector>>(m, "CKKSVector",
                                                         py::module_local())
+        // encrypting from the buffer of a NumPy array, without copying it
+        .def(py::init([](const shared_ptr<TenSEALContext> &ctx,
+                         const py::array_t<double, py::array::c_style |
+                                                       py::array::forcecast>
+                             &data,
+                         std::optional<double> scale) {
+                 if (data.ndim() != 1)
+                     throw invalid_argument("can only encrypt a vector");
+                 return CKKSVector::Create(
+                     ctx, gsl::span<const double>(data.data(), data.size()),
+                     scale);
+             }),
+             py::arg("context"), py::arg("data"),
+             py::arg("scale") = py::none(),
+             py::call_guard<py::scoped_ostream_redirect,
+                            py::scoped_estream_redirect>())
         // specifying scale
         .def(py::init([](const shared_ptr<TenSEALContext> &ctx,
                          const vector<double> &data, double scale) {
@@ -435,7 +830,7 @@ void bind_ckks_vector(py::module &m) {
         .def("neg_", &CKKSVector::negate_inplace)
         .def("square", &CKKSVector::square)
         .def("square_", &CKKSVector::square_inplace)
-        .def("pow", &CKKSVector::power)
+        .def("pow", &CKKSVector::power, release_gil())
         .def("pow_", &CKKSVector::power_inplace)
         .def("add", &CKKSVector::add)
         .def("add_", &CKKSVector::add_inplace)
@@ -479,25 +874,45 @@ void bind_ckks_vector(py::module &m) {
              [](shared_ptr<CKKSVector> obj, const vector<double> &other) {
                  return obj->mul_plain_inplace(other);
              })
-        .def("polyval", &CKKSVector::polyval)
+        .def("polyval", &CKKSVector::polyval, release_gil())
         .def("polyval_", &CKKSVector::polyval_inplace)
         // because dot doesn't have a magic function like __add__
         // we prefer to overload it instead of having dot_plain functions
-        .def("dot", &CKKSVector::dot)
-        .def("dot", &CKKSVector::dot_plain)
+        .def("dot", &CKKSVector::dot, release_gil())
+        .def("dot", &CKKSVector::dot_plain, release_gil())
         .def("dot_", &CKKSVector::dot_inplace)
         .def("dot_", &CKKSVector::dot_plain_inplace)
-        .def("sum", &CKKSVector::sum, py::arg("axis") = 0)
+        .def("sum", &CKKSVector::sum, release_gil(), py::arg("axis") = 0)
         .def("sum_", &CKKSVector::sum_inplace, py::arg("axis") = 0)
-        .def("matmul", &CKKSVector::matmul_plain)
-        .def("matmul_", &CKKSVector::matmul_plain_inplace)
-        .def("mm", &CKKSVector::matmul_plain)
-        .def("mm_", &CKKSVector::matmul_plain_inplace)
+        .def("matmul",
+             py::overload_cast<const PlainTensor<double> &>(
+                 &CKKSVector::matmul_plain, py::const_),
+             release_gil())
+        .def("matmul_", py::overload_cast<const PlainTensor<double> &>(
+                            &CKKSVector::matmul_plain_inplace))
+        .def("mm",
+             py::overload_cast<const PlainTensor<double> &>(
+                 &CKKSVector::matmul_plain, py::const_),
+             release_gil())
+        .def("mm_", py::overload_cast<const PlainTensor<double> &>(
+                        &CKKSVector::matmul_plain_inplace))
+        .def("mm",
+             py::overload_cast<const shared_ptr<EncodedMatrix> &>(
+                 &CKKSVector::matmul_plain, py::const_),
+             release_gil())
+        .def("mm_", py::overload_cast<const shared_ptr<EncodedMatrix> &>(
+                        &CKKSVector::matmul_plain_inplace))
+        .def("mm_async",
+             [](shared_ptr<CKKSVector> obj,
+                const shared_ptr<EncodedMatrix> &matrix) {
+                 return obj->matmul_plain_async(matrix).share();
+             })
         .def("conv2d_im2col",
              [](shared_ptr<CKKSVector> obj,
                 const vector<vector<double>> &matrix, const size_t windows_nb) {
                  return obj->conv2d_im2col(matrix, windows_nb);
-             })
+             },
+             release_gil())
         .def("conv2d_im2col_",
              [](shared_ptr<CKKSVector> obj,
                 const vector<vector<double>> &matrix, const size_t windows_nb) {
@@ -507,7 +922,8 @@ void bind_ckks_vector(py::module &m) {
              [](shared_ptr<CKKSVector> obj, const vector<double> &matrix,
                 size_t row_size) {
                  return obj->enc_matmul_plain(matrix, row_size);
-             })
+             },
+             release_gil())
         .def("enc_matmul_plain_",
              [](shared_ptr<CKKSVector> obj, const vector<double> &matrix,
                 size_t row_size) {
@@ -593,8 +1009,10 @@ void bind_ckks_vector(py::module &m) {
              [](shared_ptr<CKKSVector> obj, const vector<double> &other) {
                  return obj->mul_plain_inplace(other);
              })
-        .def("__matmul__", &CKKSVector::matmul_plain)
-        .def("__imatmul__", &CKKSVector::matmul_plain_inplace)
+        .def("__matmul__", py::overload_cast<const PlainTensor<double> &>(
+                               &CKKSVector::matmul_plain, py::const_))
+        .def("__imatmul__", py::overload_cast<const PlainTensor<double> &>(
+                                &CKKSVector::matmul_plain_inplace))
         .def("context", &CKKSVector::tenseal_context)
         .def("link_context", &CKKSVector::link_tenseal_context)
         .def("serialize",
@@ -678,7 +1096,7 @@ void bind_ckks_tensor(py::module &m) {
              [](shared_ptr<CKKSTensor> obj, const shared_ptr<SecretKey> &sk) {
                  return obj->decrypt(sk);
              })
-        .def("sum", &CKKSTensor::sum, py::arg("axis") = 0)
+        .def("sum", &CKKSTensor::sum, release_gil(), py::arg("axis") = 0)
         .def("sum_", &CKKSTensor::sum_inplace, py::arg("axis") = 0)
         .def("sum_batch", &CKKSTensor::sum_batch)
         .def("sum_batch_", &CKKSTensor::sum_batch_inplace)
@@ -686,7 +1104,7 @@ void bind_ckks_tensor(py::module &m) {
         .def("neg_", &CKKSTensor::negate_inplace)
         .def("square", &CKKSTensor::square)
         .def("square_", &CKKSTensor::square_inplace)
-        .def("pow", &CKKSTensor::power)
+        .def("pow", &CKKSTensor::power, release_gil())
         .def("pow_", &CKKSTensor::power_inplace)
         .def("add", &CKKSTensor::add)
         .def("add_", &CKKSTensor::add_inplace)
@@ -718,19 +1136,19 @@ void bind_ckks_tensor(py::module &m) {
              py::overload_cast<const double &>(&CKKSTensor::mul_plain_inplace))
         .def("mul_plain_", py::overload_cast<const PlainTensor<double> &>(
                                &CKKSTensor::mul_plain_inplace))
-        .def("polyval", &CKKSTensor::polyval)
+        .def("polyval", &CKKSTensor::polyval, release_gil())
         .def("polyval_", &CKKSTensor::polyval_inplace)
-        .def("dot", &CKKSTensor::dot)
+        .def("dot", &CKKSTensor::dot, release_gil())
         .def("dot_", &CKKSTensor::dot_inplace)
-        .def("dot", &CKKSTensor::dot_plain)
+        .def("dot", &CKKSTensor::dot_plain, release_gil())
         .def("dot_", &CKKSTensor::dot_plain_inplace)
-        .def("matmul", &CKKSTensor::matmul)
+        .def("matmul", &CKKSTensor::matmul, release_gil())
         .def("matmul_", &CKKSTensor::matmul_inplace)
-        .def("matmul", &CKKSTensor::matmul_plain)
+        .def("matmul", &CKKSTensor::matmul_plain, release_gil())
         .def("matmul_", &CKKSTensor::matmul_plain_inplace)
-        .def("mm", &CKKSTensor::matmul)
+        .def("mm", &CKKSTensor::matmul, release_gil())
         .def("mm_", &CKKSTensor::matmul_inplace)
-        .def("mm", &CKKSTensor::matmul_plain)
+        .def("mm", &CKKSTensor::matmul_plain, release_gil())
         .def("mm_", &CKKSTensor::matmul_plain_inplace)
         // python arithmetic
         .def("__add__", &CKKSTensor::add)
@@ -847,7 +1265,7 @@ void bind_bfv_tensor(py::module &m) {
              [](shared_ptr<BFVTensor> obj, const shared_ptr<SecretKey> &sk) {
                  return obj->decrypt(sk);
              })
-        .def("sum", &BFVTensor::sum, py::arg("axis") = 0)
+        .def("sum", &BFVTensor::sum, release_gil(), py::arg("axis") = 0)
         .def("sum_", &BFVTensor::sum_inplace, py::arg("axis") = 0)
         .def("sum_batch", &BFVTensor::sum_batch)
         .def("sum_batch_", &BFVTensor::sum_batch_inplace)
@@ -855,7 +1273,7 @@ void bind_bfv_tensor(py::module &m) {
         .def("neg_", &BFVTensor::negate_inplace)
         .def("square", &BFVTensor::square)
         .def("square_", &BFVTensor::square_inplace)
-        .def("pow", &BFVTensor::power)
+        .def("pow", &BFVTensor::power, release_gil())
         .def("pow_", &BFVTensor::power_inplace)
         .def("add", &BFVTensor::add)
         .def("add_", &BFVTensor::add_inplace)
@@ -887,19 +1305,19 @@ void bind_bfv_tensor(py::module &m) {
              py::overload_cast<const int64_t &>(&BFVTensor::mul_plain_inplace))
         .def("mul_plain_", py::overload_cast<const PlainTensor<int64_t> &>(
                                &BFVTensor::mul_plain_inplace))
-        .def("polyval", &BFVTensor::polyval)
+        .def("polyval", &BFVTensor::polyval, release_gil())
         .def("polyval_", &BFVTensor::polyval_inplace)
-        .def("dot", &BFVTensor::dot)
+        .def("dot", &BFVTensor::dot, release_gil())
         .def("dot_", &BFVTensor::dot_inplace)
-        .def("dot", &BFVTensor::dot_plain)
+        .def("dot", &BFVTensor::dot_plain, release_gil())
         .def("dot_", &BFVTensor::dot_plain_inplace)
-        .def("matmul", &BFVTensor::matmul)
+        .def("matmul", &BFVTensor::matmul, release_gil())
         .def("matmul_", &BFVTensor::matmul_inplace)
-        .def("matmul", &BFVTensor::matmul_plain)
+        .def("matmul", &BFVTensor::matmul_plain, release_gil())
         .def("matmul_", &BFVTensor::matmul_plain_inplace)
-        .def("mm", &BFVTensor::matmul)
+        .def("mm", &BFVTensor::matmul, release_gil())
         .def("mm_", &BFVTensor::matmul_inplace)
-        .def("mm", &BFVTensor::matmul_plain)
+        .def("mm", &BFVTensor::matmul_plain, release_gil())
         .def("mm_", &BFVTensor::matmul_plain_inplace)
         // python arithmetic
         .def("__add__", &BFVTensor::add)
@@ -994,10 +1412,16 @@ PYBIND11_MODULE(_tenseal_cpp, m) {
 
     bind_globals(m);
 
+    bind_cancellation(m);
+
+    bind_metrics(m);
+
     bind_sealapi(m);
 
     bind_context(m);
 
+    bind_rotation_planner(m);
+
     bind_plain_tensor<double>(m, "Double");
     bind_plain_tensor<int64_t>(m, "Int64");
 
@@ -1005,4 +1429,9 @@ PYBIND11_MODULE(_tenseal_cpp, m) {
     bind_ckks_vector(m);
     bind_ckks_tensor(m);
     bind_bfv_tensor(m);
+
+    bind_async_ops<BFVVector, int64_t>(m, "BFVVector");
+    bind_async_ops<CKKSVector, double>(m, "CKKSVector");
+    bind_async_ops<CKKSTensor, double>(m, "CKKSTensor");
+    bind_async_ops<BFVTensor, int64_t>(m, "BFVTensor");
 }
@@ -0,0 +1,36 @@
+"""Cancellation of long running encrypted computations."""
+import tenseal as ts
+
+
+OperationCancelled = ts._ts_cpp.OperationCancelled
+
+
+class CancellationToken:
+    def __init__(self, timeout: float = None):
+        """Token stopping the operations run while it's active, either when cancel()
+        is called or after a timeout. The token is activated on the current thread
+        using a `with` statement, the parallel and asynchronous jobs spawned by the
+        operations observe it as well. Cancelled operations raise OperationCancelled.
+
+        Args:
+            timeout: number of seconds after which the operations are cancelled.
+        """
+        self.data = ts._ts_cpp.CancellationToken()
+        if timeout is not None:
+            self.data.timeout(timeout)
+        self._previous = []
+
+    def cancel(self):
+        """Cancel the operations observing the token. Safe to call from any thread."""
+        self.data.cancel()
+
+    @property
+    def cancelled(self) -> bool:
+        return self.data.cancelled()
+
+    def __enter__(self) -> "CancellationToken":
+        self._previous.append(ts._ts_cpp.CancellationToken.exchange_current(self.data))
+        return self
+
+    def __exit__(self, *args):
+        ts._ts_cpp.CancellationToken.exchange_current(self._previous.pop())
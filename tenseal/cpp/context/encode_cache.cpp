@@ -0,0 +1,80 @@
+#include "tenseal/cpp/context/encode_cache.h"
+
+namespace tenseal {
+
+using namespace seal;
+using namespace std;
+
+EncodeCache::key_t EncodeCache::key(gsl::span<const double> values,
+                                    double scale,
+                                    const parms_id_type& parms_id) {
+    static_assert(sizeof(double) == sizeof(uint64_t));
+    // the hash function only reads the bytes of the values
+    digest_t value_digest;
+    util::HashFunction::hash(
+        reinterpret_cast<const uint64_t*>(values.data()), values.size(),
+        value_digest);
+    return {value_digest, scale, parms_id};
+}
+
+bool EncodeCache::find(const key_t& key, Plaintext& destination) {
+    shared_ptr<const Plaintext> plaintext;
+    {
+        std::scoped_lock lock{_mutex};
+        auto it = _index.find(key);
+        if (it == _index.end()) {
+            _misses++;
+            return false;
+        }
+        _hits++;
+        _entries.splice(_entries.begin(), _entries, it->second);
+        plaintext = it->second->second;
+    }
+
+    // copied outside of the lock, the cached plaintexts are never modified
+    destination = *plaintext;
+    return true;
+}
+
+void EncodeCache::insert(const key_t& key, const Plaintext& plaintext) {
+    auto cached = make_shared<const Plaintext>(plaintext);
+
+    std::scoped_lock lock{_mutex};
+    if (_capacity == 0 || _index.find(key) != _index.end()) return;
+
+    _entries.emplace_front(key, cached);
+    _index[key] = _entries.begin();
+    this->evict();
+}
+
+void EncodeCache::capacity(size_t capacity) {
+    std::scoped_lock lock{_mutex};
+    _capacity = capacity;
+    this->evict();
+}
+
+size_t EncodeCache::capacity() const {
+    std::scoped_lock lock{_mutex};
+    return _capacity;
+}
+
+EncodeCacheStats EncodeCache::stats() const {
+    std::scoped_lock lock{_mutex};
+    return {_hits, _misses, _entries.size(), _capacity};
+}
+
+void EncodeCache::clear() {
+    std::scoped_lock lock{_mutex};
+    _entries.clear();
+    _index.clear();
+    _hits = _misses = 0;
+}
+
+void EncodeCache::evict() {
+    while (_entries.size() > _capacity) {
+        _index.erase(_entries.back().first);
+        _entries.pop_back();
+    }
+}
+
+}  // namespace tenseal
@@ -0,0 +1,83 @@
+#ifndef TENSEAL_CONTEXT_ENCODE_CACHE_H
+#define TENSEAL_CONTEXT_ENCODE_CACHE_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "gsl/span"
+#include "seal/seal.h"
+#include "tenseal/cpp/context/registry.h"
+
+namespace tenseal {
+
+using namespace seal;
+using namespace std;
+
+/**
+ * Counters of an EncodeCache.
+ **/
+struct EncodeCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+/**
+ * Bounded LRU cache of CKKS encoded plaintexts, keyed by the digest of the
+ *encoded values, the scale and the parms_id the values were encoded at. It
+ *spares encoding the same plain operands, e.g. the weights of a model, on
+ *every operation. It's disabled until given a capacity.
+ **/
+class EncodeCache {
+   public:
+    using key_t = tuple<digest_t, double, parms_id_type>;
+
+    /**
+     * @returns the key of "values" encoded at "scale" and "parms_id".
+     **/
+    static key_t key(gsl::span<const double> values, double scale,
+                     const parms_id_type& parms_id);
+
+    /**
+     * Copy the cached plaintext of "key" to "destination".
+     * @returns false on a cache miss.
+     **/
+    bool find(const key_t& key, Plaintext& destination);
+    /**
+     * Cache the plaintext of "key", evicting the least recently used
+     *plaintexts above the capacity.
+     **/
+    void insert(const key_t& key, const Plaintext& plaintext);
+
+    /**
+     * Set the maximum number of cached plaintexts, 0 disables the cache.
+     **/
+    void capacity(size_t capacity);
+    size_t capacity() const;
+    bool enabled() const { return this->capacity() > 0; }
+
+    EncodeCacheStats stats() const;
+    /**
+     * Release the cached plaintexts and reset the counters.
+     **/
+    void clear();
+
+   private:
+    void evict();
+
+    mutable std::mutex _mutex;
+    size_t _capacity = 0;
+    size_t _hits = 0;
+    size_t _misses = 0;
+    // most recently used first
+    list<pair<key_t, shared_ptr<const Plaintext>>> _entries;
+    map<key_t, decltype(_entries)::iterator> _index;
+};
+
+}  // namespace tenseal
+
+#endif
@@ -0,0 +1,255 @@
+#include "tenseal/cpp/context/galois_key_store.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TENSEAL_USE_MMAP
+#endif
+
+namespace tenseal {
+
+using namespace seal;
+using namespace std;
+
+namespace {
+/**
+ * Layout of a store: a header made of the magic number, the format version,
+ *the parms_id of the keys, the digest of the keys and the number of Galois
+ *elements, followed by one (galois_elt, key_count, offset, size) entry per
+ *element. The keys of every element are saved uncompressed, from a page
+ *aligned offset.
+ **/
+constexpr uint64_t store_magic = 0x59454b534c475354;  // "TSGLSKEY"
+constexpr uint64_t store_version = 2;
+constexpr uint64_t store_page_size = 4096;
+constexpr size_t header_bytes = 11 * sizeof(uint64_t);
+constexpr size_t entry_bytes = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+uint64_t page_align(uint64_t offset) {
+    return (offset + store_page_size - 1) / store_page_size * store_page_size;
+}
+
+template <typename T>
+void write_value(ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void write_padding(ostream& out, uint64_t offset) {
+    auto position = static_cast<uint64_t>(out.tellp());
+    if (position < offset) {
+        vector<char> zeros(offset - position, 0);
+        out.write(zeros.data(), zeros.size());
+    }
+}
+}  // namespace
+
+GaloisKeyStore::GaloisKeyStore(const std::string& path,
+                               shared_ptr<SEALContext> context)
+    : _path(path), _context(context) {
+    if (_context == nullptr) throw invalid_argument("invalid context");
+
+#ifdef TENSEAL_USE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw invalid_argument("failed to open the key store " + path);
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw invalid_argument("failed to open the key store " + path);
+    }
+    _size = static_cast<size_t>(info.st_size);
+
+    if (_size > 0) {
+        void* addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED)
+            throw invalid_argument("failed to map the key store " + path);
+        // the keys are accessed by element, reading ahead doesn't help
+        ::madvise(addr, _size, MADV_RANDOM);
+        _data = static_cast<const seal_byte*>(addr);
+    } else {
+        ::close(fd);
+    }
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) throw invalid_argument("failed to open the key store " + path);
+    _size = static_cast<size_t>(in.tellg());
+    _buffer.resize(_size);
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(_buffer.data()), _size);
+    _data = _buffer.data();
+#endif
+
+    auto read_value = [&](size_t offset, auto& value) {
+        if (offset + sizeof(value) > _size)
+            throw invalid_argument("truncated key store " + path);
+        std::memcpy(&value, _data + offset, sizeof(value));
+        return offset + sizeof(value);
+    };
+
+    uint64_t magic = 0, version = 0, count = 0;
+    size_t offset = read_value(0, magic);
+    if (magic != store_magic)
+        throw invalid_argument("not a key store " + path);
+    offset = read_value(offset, version);
+    if (version != store_version)
+        throw invalid_argument("unsupported key store version");
+    for (auto& word : _parms_id) offset = read_value(offset, word);
+    if (_parms_id != _context->key_parms_id())
+        throw invalid_argument(
+            "the key store doesn't match the encryption parameters");
+    for (auto& word : _digest) offset = read_value(offset, word);
+    offset = read_value(offset, count);
+
+    auto& parms = _context->key_context_data()->parms();
+    size_t max_elt = 2 * parms.poly_modulus_degree();
+    for (uint64_t i = 0; i < count; ++i) {
+        uint32_t elt = 0;
+        Entry entry;
+        offset = read_value(offset, elt);
+        offset = read_value(offset, entry.key_count);
+        offset = read_value(offset, entry.offset);
+        offset = read_value(offset, entry.size);
+
+        if (elt % 2 == 0 || elt >= max_elt || entry.offset > _size ||
+            entry.size > _size - entry.offset)
+            throw invalid_argument("corrupted key store " + path);
+        _entries[elt] = entry;
+    }
+}
+
+GaloisKeyStore::~GaloisKeyStore() {
+#ifdef TENSEAL_USE_MMAP
+    if (_data != nullptr)
+        ::munmap(const_cast<seal_byte*>(_data), _size);
+#endif
+}
+
+shared_ptr<GaloisKeyStore> GaloisKeyStore::Create(
+    const std::string& path, shared_ptr<SEALContext> context,
+    const GaloisKeys& keys) {
+    if (context == nullptr) throw invalid_argument("invalid context");
+
+    vector<uint32_t> elts;
+    for (size_t i = 0; i < keys.data().size(); ++i)
+        if (!keys.data()[i].empty())
+            elts.push_back(static_cast<uint32_t>(2 * i + 1));
+
+    // the store is written aside then renamed over "path": truncating a file
+    // mapped by another store would fault its next reads. The temporary file
+    // is unique, so concurrent writers of the same path don't clobber it.
+#ifdef TENSEAL_USE_MMAP
+    std::string tmp_path = path + ".XXXXXX";
+    int fd = ::mkstemp(&tmp_path[0]);
+    if (fd < 0)
+        throw invalid_argument("failed to create the key store " + path);
+    ::close(fd);
+#else
+    auto tmp_path = path + ".tmp";
+#endif
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::remove(tmp_path.c_str());
+        throw invalid_argument("failed to create the key store " + path);
+    }
+
+    try {
+        // the keys are written first, the entries are known afterwards
+        map<uint32_t, Entry> entries;
+        uint64_t offset = page_align(header_bytes + elts.size() * entry_bytes);
+        for (auto elt : elts) {
+            write_padding(out, offset);
+
+            Entry entry{0, offset, 0};
+            for (const auto& key : keys.data()[GaloisKeys::get_index(elt)]) {
+                key.save(out, compr_mode_type::none);
+                entry.key_count++;
+            }
+            entry.size = static_cast<uint64_t>(out.tellp()) - offset;
+            entries[elt] = entry;
+            offset = page_align(offset + entry.size);
+        }
+
+        out.seekp(0);
+        write_value(out, store_magic);
+        write_value(out, store_version);
+        for (auto word : keys.parms_id()) write_value(out, word);
+        for (auto word : digest(keys)) write_value(out, word);
+        write_value(out, static_cast<uint64_t>(elts.size()));
+        for (const auto& [elt, entry] : entries) {
+            write_value(out, elt);
+            write_value(out, entry.key_count);
+            write_value(out, entry.offset);
+            write_value(out, entry.size);
+        }
+    } catch (...) {
+        out.close();
+        std::remove(tmp_path.c_str());
+        throw;
+    }
+    out.close();
+    if (!out) {
+        std::remove(tmp_path.c_str());
+        throw invalid_argument("failed to write the key store " + path);
+    }
+#ifndef TENSEAL_USE_MMAP
+    // rename doesn't replace an existing file on every platform
+    std::remove(path.c_str());
+#endif
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        throw invalid_argument("failed to write the key store " + path);
+    }
+
+    return Open(path, context);
+}
+
+shared_ptr<GaloisKeyStore> GaloisKeyStore::Open(
+    const std::string& path, shared_ptr<SEALContext> context) {
+    return shared_ptr<GaloisKeyStore>(new GaloisKeyStore(path, context));
+}
+
+bool GaloisKeyStore::has_key(uint32_t galois_elt) const {
+    return _entries.find(galois_elt) != _entries.end();
+}
+
+vector<uint32_t> GaloisKeyStore::galois_elts() const {
+    vector<uint32_t> elts;
+    for (const auto& [elt, entry] : _entries) elts.push_back(elt);
+    return elts;
+}
+
+void GaloisKeyStore::load(const vector<uint32_t>& galois_elts,
+                          GaloisKeys& destination) const {
+    destination.parms_id() = _parms_id;
+
+    for (auto elt : galois_elts) {
+        auto it = _entries.find(elt);
+        if (it == _entries.end()) continue;
+        const auto& entry = it->second;
+
+        vector<PublicKey> keys(entry.key_count);
+        const seal_byte* data = _data + entry.offset;
+        size_t remaining = entry.size;
+        for (auto& key : keys) {
+            auto read =
+                static_cast<size_t>(key.load(*_context, data, remaining));
+            data += read;
+            remaining -= read;
+        }
+
+        auto index = GaloisKeys::get_index(elt);
+        if (destination.data().size() <= index)
+            destination.data().resize(index + 1);
+        destination.data()[index] = std::move(keys);
+    }
+}
+
+}  // namespace tenseal
@@ -0,0 +1,94 @@
+#ifndef TENSEAL_CONTEXT_GALOIS_KEY_STORE_H
+#define TENSEAL_CONTEXT_GALOIS_KEY_STORE_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "seal/seal.h"
+#include "tenseal/cpp/context/registry.h"
+
+namespace tenseal {
+
+using namespace seal;
+using namespace std;
+
+/**
+ * A flat file holding the Galois keys of a context, with one page aligned
+ *block per Galois element. The file is memory mapped and the key of an
+ *element is only deserialized when it's first requested, so the keys a
+ *workload never uses are left on disk, and can be paged out by the OS once
+ *loaded.
+ **/
+class GaloisKeyStore {
+   public:
+    GaloisKeyStore(const GaloisKeyStore&) = delete;
+    GaloisKeyStore& operator=(const GaloisKeyStore&) = delete;
+    ~GaloisKeyStore();
+
+    /**
+     * Write "keys" to a new store at "path", replacing any existing file,
+     *then map it. The file is replaced by a rename, so the stores still
+     *mapping the previous one keep reading it.
+     * @throws invalid_argument if the file can't be written.
+     **/
+    static shared_ptr<GaloisKeyStore> Create(const std::string& path,
+                                             shared_ptr<SEALContext> context,
+                                             const GaloisKeys& keys);
+    /**
+     * Map an existing store.
+     * @throws invalid_argument if the file can't be read, or if it doesn't
+     *hold keys for the parameters of "context".
+     **/
+    static shared_ptr<GaloisKeyStore> Open(const std::string& path,
+                                           shared_ptr<SEALContext> context);
+
+    /**
+     * @returns whether the store holds the key of a Galois element.
+     **/
+    bool has_key(uint32_t galois_elt) const;
+    /**
+     * @returns the Galois elements of the stored keys.
+     **/
+    vector<uint32_t> galois_elts() const;
+    /**
+     * Deserialize the keys of "galois_elts" into "destination", the elements
+     *missing from the store are skipped.
+     **/
+    void load(const vector<uint32_t>& galois_elts,
+              GaloisKeys& destination) const;
+    /**
+     * @returns the digest of the stored keys, read from the header of the
+     *file. It matches the digest of the keys the store was created from.
+     **/
+    const digest_t& keys_digest() const { return _digest; }
+    /**
+     * @returns the path of the store.
+     **/
+    const std::string& path() const { return _path; }
+
+   private:
+    struct Entry {
+        uint32_t key_count;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    GaloisKeyStore(const std::string& path, shared_ptr<SEALContext> context);
+
+    std::string _path;
+    shared_ptr<SEALContext> _context;
+    parms_id_type _parms_id;
+    digest_t _digest;
+    map<uint32_t, Entry> _entries;
+
+    const seal_byte* _data = nullptr;
+    size_t _size = 0;
+    // without mmap, the file is read in memory
+    vector<seal_byte> _buffer;
+};
+
+}  // namespace tenseal
+
+#endif
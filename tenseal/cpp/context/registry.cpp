@@ -0,0 +1,175 @@
+#include "tenseal/cpp/context/registry.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace tenseal {
+
+using namespace seal;
+using namespace std;
+
+namespace {
+digest_t hash_words(const vector<uint64_t>& words) {
+    digest_t result;
+    util::HashFunction::hash(words.data(), words.size(), result);
+    return result;
+}
+
+void append(vector<uint64_t>& words, const digest_t& value) {
+    words.insert(words.end(), value.begin(), value.end());
+}
+}  // namespace
+
+digest_t digest(const std::string& bytes) {
+    // the buffer is hashed by chunks, then the digests of the chunks are
+    // hashed, to avoid copying big keys into a word aligned buffer
+    constexpr size_t chunk_bytes = 1 << 16;
+    vector<uint64_t> chunk;
+    vector<uint64_t> words{bytes.size()};
+    for (size_t offset = 0; offset < bytes.size(); offset += chunk_bytes) {
+        size_t length = min(chunk_bytes, bytes.size() - offset);
+        chunk.assign((length + 7) / 8, 0);
+        std::memcpy(chunk.data(), bytes.data() + offset, length);
+        append(words, hash_words(chunk));
+    }
+    return hash_words(words);
+}
+
+digest_t digest(const EncryptionParameters& parms) {
+    vector<uint64_t> words{static_cast<uint64_t>(parms.scheme()),
+                           parms.poly_modulus_degree(),
+                           parms.plain_modulus().value()};
+    for (const auto& modulus : parms.coeff_modulus())
+        words.push_back(modulus.value());
+    return hash_words(words);
+}
+
+digest_t digest(const PublicKey& key) {
+    const auto& ct = key.data();
+    vector<uint64_t> words(ct.parms_id().begin(), ct.parms_id().end());
+
+    digest_t polys;
+    util::HashFunction::hash(ct.data(), ct.dyn_array().size(), polys);
+    append(words, polys);
+    return hash_words(words);
+}
+
+digest_t digest(const SecretKey& key) {
+    const auto& pt = key.data();
+    vector<uint64_t> words(pt.parms_id().begin(), pt.parms_id().end());
+
+    digest_t poly;
+    util::HashFunction::hash(pt.data(), pt.coeff_count(), poly);
+    append(words, poly);
+    return hash_words(words);
+}
+
+digest_t digest(const KSwitchKeys& keys) {
+    vector<uint64_t> words(keys.parms_id().begin(), keys.parms_id().end());
+    for (size_t i = 0; i < keys.data().size(); ++i) {
+        if (keys.data()[i].empty()) continue;
+        words.push_back(i);
+        for (const auto& key : keys.data()[i]) append(words, digest(key));
+    }
+    return hash_words(words);
+}
+
+ContextRegistry& ContextRegistry::instance() {
+    static ContextRegistry registry;
+    return registry;
+}
+
+pair<shared_ptr<SEALContext>, shared_ptr<Evaluator>> ContextRegistry::backend(
+    const EncryptionParameters& parms) {
+    auto id = digest(parms);
+
+    entry_id recent_id{type_index(typeid(SEALContext)), id};
+
+    std::scoped_lock lock{_mutex};
+    auto it = _backends.find(id);
+    if (it != _backends.end()) {
+        auto sealctx = it->second.first.lock();
+        auto evaluator = it->second.second.lock();
+        if (sealctx && evaluator) {
+            this->retain(recent_id, {sealctx, evaluator});
+            return {sealctx, evaluator};
+        }
+    }
+
+    this->forget_expired();
+    auto sealctx = make_shared<SEALContext>(parms);
+    auto evaluator = make_shared<Evaluator>(*sealctx);
+    _backends[id] = {sealctx, evaluator};
+    this->retain(recent_id, {sealctx, evaluator});
+    return {sealctx, evaluator};
+}
+
+void ContextRegistry::clear() {
+    std::scoped_lock lock{_mutex};
+    _backends.clear();
+    _keys.clear();
+    _recent.clear();
+    _recent_index.clear();
+}
+
+void ContextRegistry::capacity(size_t value) {
+    std::scoped_lock lock{_mutex};
+    _capacity = value;
+    this->shrink_recent();
+}
+
+size_t ContextRegistry::capacity() const {
+    std::scoped_lock lock{_mutex};
+    return _capacity;
+}
+
+void ContextRegistry::retain(const entry_id& id,
+                             vector<shared_ptr<const void>> objects) {
+    auto it = _recent_index.find(id);
+    if (it != _recent_index.end()) {
+        _recent.erase(it->second);
+        _recent_index.erase(it);
+    }
+    if (_capacity == 0) return;
+
+    _recent.emplace_front(id, std::move(objects));
+    _recent_index[id] = _recent.begin();
+    this->shrink_recent();
+}
+
+void ContextRegistry::shrink_recent() {
+    while (_recent.size() > _capacity) {
+        _recent_index.erase(_recent.back().first);
+        _recent.pop_back();
+    }
+}
+
+size_t ContextRegistry::size() const {
+    std::scoped_lock lock{_mutex};
+    size_t count = 0;
+    for (const auto& [id, backend] : _backends)
+        if (!backend.first.expired() && !backend.second.expired()) ++count;
+    for (const auto& [id, key] : _keys)
+        if (!key.expired()) ++count;
+    return count;
+}
+
+void ContextRegistry::forget_expired() {
+    auto erase_if = [](auto& entries, auto expired) {
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (expired(it->second))
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+    };
+    erase_if(_backends, [](const auto& backend) {
+        return backend.first.expired() || backend.second.expired();
+    });
+    erase_if(_keys, [](const auto& key) { return key.expired(); });
+    erase_if(_digests,
+             [](const auto& value) { return value.first.expired(); });
+}
+
+}  // namespace tenseal
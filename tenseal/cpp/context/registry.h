@@ -0,0 +1,160 @@
+#ifndef TENSEAL_CONTEXT_REGISTRY_H
+#define TENSEAL_CONTEXT_REGISTRY_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+#include "seal/seal.h"
+#include "seal/util/hash.h"
+
+namespace tenseal {
+
+using namespace seal;
+using namespace std;
+
+/**
+ * Collision resistant digest, computed with the hash function SEAL uses for
+ *the parms_id.
+ **/
+using digest_t = util::HashFunction::hash_block_type;
+
+/**
+ * @returns the digest of a buffer.
+ **/
+digest_t digest(const std::string& bytes);
+/**
+ * @returns the digest of a set of encryption parameters.
+ **/
+digest_t digest(const EncryptionParameters& parms);
+/**
+ * @returns the digest of the parameters and the polynomials of a key.
+ **/
+digest_t digest(const PublicKey& key);
+digest_t digest(const SecretKey& key);
+digest_t digest(const KSwitchKeys& keys);
+
+/**
+ * Process-wide registry of the immutable parts of the contexts. It interns
+ *the SEALContext and Evaluator built for a set of encryption parameters, and
+ *the public keys deserialized from a buffer, so that loading the same context
+ *again doesn't recompute the NTT tables or reload the keys. The entries are
+ *shared as long as a context uses them, and the most recently used ones are
+ *also kept alive, up to a capacity, for the contexts loaded afterwards.
+ *It also caches the digests of the keys, which are never modified once
+ *created.
+ **/
+class ContextRegistry {
+   public:
+    static ContextRegistry& instance();
+
+    /**
+     * @returns the SEALContext and Evaluator for "parms", building them on
+     *first use.
+     **/
+    pair<shared_ptr<SEALContext>, shared_ptr<Evaluator>> backend(
+        const EncryptionParameters& parms);
+
+    /**
+     * @returns the key deserialized from "bytes", calling "load" on first
+     *use.
+     **/
+    template <class T, class Loader>
+    shared_ptr<T> key(const std::string& bytes, Loader&& load) {
+        auto id = make_pair(type_index(typeid(T)), digest(bytes));
+        {
+            std::scoped_lock lock{_mutex};
+            auto it = _keys.find(id);
+            if (it != _keys.end()) {
+                if (auto key = it->second.lock()) {
+                    this->retain(id, {key});
+                    return static_pointer_cast<T>(key);
+                }
+            }
+        }
+
+        // loaded outside of the lock, a concurrent load of the same key
+        // keeps the first one registered
+        shared_ptr<T> loaded = load();
+        std::scoped_lock lock{_mutex};
+        this->forget_expired();
+        auto& entry = _keys[id];
+        if (auto key = entry.lock()) {
+            this->retain(id, {key});
+            return static_pointer_cast<T>(key);
+        }
+        entry = loaded;
+        this->retain(id, {loaded});
+        return loaded;
+    }
+
+    /**
+     * @returns the digest of a key, computed once per key object.
+     **/
+    template <class T>
+    digest_t key_digest(const shared_ptr<T>& key) {
+        {
+            std::scoped_lock lock{_mutex};
+            auto it = _digests.find(key.get());
+            if (it != _digests.end() && !it->second.first.expired())
+                return it->second.second;
+        }
+
+        auto value = digest(*key);
+        std::scoped_lock lock{_mutex};
+        this->forget_expired();
+        _digests[key.get()] = {weak_ptr<const void>(key), value};
+        return value;
+    }
+
+    /**
+     * Release the interned backends and keys.
+     **/
+    void clear();
+    /**
+     * @returns the number of interned backends and keys still in use.
+     **/
+    size_t size() const;
+    /**
+     * Set the number of recently used backends and keys kept alive once no
+     *context uses them, the least recently used ones are released first.
+     **/
+    void capacity(size_t value);
+    size_t capacity() const;
+
+    static constexpr size_t default_capacity = 16;
+
+   private:
+    using entry_id = pair<type_index, digest_t>;
+
+    ContextRegistry() = default;
+
+    /**
+     * Drop the entries whose object was released.
+     **/
+    void forget_expired();
+    /**
+     * Keep "objects" alive as the most recently used entry "id", releasing
+     *the least recently used entries past the capacity.
+     **/
+    void retain(const entry_id& id, vector<shared_ptr<const void>> objects);
+    void shrink_recent();
+
+    mutable std::mutex _mutex;
+    size_t _capacity = default_capacity;
+    list<pair<entry_id, vector<shared_ptr<const void>>>> _recent;
+    map<entry_id, decltype(_recent)::iterator> _recent_index;
+    map<digest_t, pair<weak_ptr<SEALContext>, weak_ptr<Evaluator>>>
+        _backends;
+    map<entry_id, weak_ptr<void>> _keys;
+    map<const void*, pair<weak_ptr<const void>, digest_t>> _digests;
+};
+
+}  // namespace tenseal
+
+#endif
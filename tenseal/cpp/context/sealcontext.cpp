@@ -1,6 +1,9 @@
 #include "tenseal/cpp/context/sealcontext.h"
 
+#include <cmath>
 #include <memory>
+#include <numeric>
+#include <stdexcept>
 
 #include "seal/seal.h"
 
@@ -41,6 +44,100 @@ EncryptionParameters create_ckks_parameters(size_t poly_modulus_degree,
     return parameters;
 }
 
+namespace {
+constexpr size_t min_poly_modulus_degree = 1024;
+constexpr size_t max_poly_modulus_degree = 32768;
+constexpr int max_prime_bits = 60;
+// bits of a scaled value lost to the encoding and rescaling noise
+constexpr int ckks_noise_bits = 20;
+constexpr int ckks_integer_bits = 20;
+constexpr int ckks_min_integer_bits = 10;
+// bits of noise budget consumed on top of log2(plain_modulus * N) by an
+// encryption or a multiplication
+constexpr int bfv_noise_margin_bits = 10;
+
+void check_security(sec_level_type security) {
+    if (security == sec_level_type::none)
+        throw invalid_argument("a security level is required");
+}
+
+/*
+Split `total_bits` in as few balanced primes as possible, followed by a
+special prime as large as the biggest of them.
+*/
+vector<int> balanced_bit_sizes(int total_bits) {
+    int count = (total_bits + max_prime_bits - 1) / max_prime_bits;
+    int bits = (total_bits + count - 1) / count;
+    return vector<int>(count + 1, bits);
+}
+}  // namespace
+
+pair<EncryptionParameters, double> select_ckks_parameters(
+    size_t depth, int precision_bits, size_t vector_size,
+    sec_level_type security) {
+    check_security(security);
+    if (precision_bits <= 0)
+        throw invalid_argument("precision_bits must be positive");
+
+    int scale_bits = precision_bits + ckks_noise_bits;
+    int outer_bits = min(scale_bits + ckks_integer_bits, max_prime_bits);
+    if (outer_bits - scale_bits < ckks_min_integer_bits)
+        throw invalid_argument("precision_bits can't exceed " +
+                               to_string(max_prime_bits - ckks_noise_bits -
+                                         ckks_min_integer_bits));
+
+    // one prime per level, plus the first and the special primes
+    vector<int> bit_sizes(depth + 2, scale_bits);
+    bit_sizes.front() = bit_sizes.back() = outer_bits;
+    int total_bits = accumulate(bit_sizes.begin(), bit_sizes.end(), 0);
+
+    for (size_t degree = min_poly_modulus_degree;
+         degree <= max_poly_modulus_degree; degree *= 2) {
+        if (degree / 2 < vector_size) continue;
+        if (total_bits > CoeffModulus::MaxBitCount(degree, security)) continue;
+        try {
+            return {create_ckks_parameters(degree, bit_sizes),
+                    pow(2.0, scale_bits)};
+        } catch (const logic_error&) {
+            // not enough primes of these sizes for this degree
+        }
+    }
+    throw invalid_argument("no CKKS parameters fit the requirements");
+}
+
+EncryptionParameters select_bfv_parameters(size_t depth,
+                                           int plain_modulus_bits,
+                                           size_t vector_size,
+                                           sec_level_type security) {
+    check_security(security);
+    if (plain_modulus_bits <= 0 || plain_modulus_bits > max_prime_bits)
+        throw invalid_argument("plain_modulus_bits must be in (0, " +
+                               to_string(max_prime_bits) + "]");
+
+    for (size_t degree = min_poly_modulus_degree;
+         degree <= max_poly_modulus_degree; degree *= 2) {
+        if (degree < vector_size) continue;
+
+        int log_degree = static_cast<int>(log2(degree));
+        int budget_bits = static_cast<int>(depth + 1) *
+                          (plain_modulus_bits + log_degree +
+                           bfv_noise_margin_bits);
+        auto bit_sizes = balanced_bit_sizes(budget_bits);
+        int total_bits = accumulate(bit_sizes.begin(), bit_sizes.end(), 0);
+        if (total_bits > CoeffModulus::MaxBitCount(degree, security)) continue;
+
+        try {
+            auto plain_modulus =
+                PlainModulus::Batching(degree, plain_modulus_bits);
+            return create_bfv_parameters(degree, plain_modulus.value(),
+                                         bit_sizes);
+        } catch (const logic_error&) {
+            // not enough primes of these sizes for this degree
+        }
+    }
+    throw invalid_argument("no BFV parameters fit the requirements");
+}
+
 SEALContext create_context(EncryptionParameters parms) {
     return SEALContext(parms);
 }
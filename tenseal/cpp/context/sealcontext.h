@@ -1,6 +1,7 @@
 #ifndef TENSEAL_CONTEXT_SEALCONTEXT_H
 #define TENSEAL_CONTEXT_SEALCONTEXT_H
 
+#include <utility>
 #include <vector>
 
 #include "seal/seal.h"
@@ -27,6 +28,33 @@ sizes.
 EncryptionParameters create_ckks_parameters(size_t poly_modulus_degree,
                                             vector<int> coeff_mod_bit_sizes);
 
+/*
+Returns the cheapest EncryptionParameters for the CKKS scheme, and the scale
+to use with them, that can evaluate circuits of multiplicative depth `depth`
+with `precision_bits` bits of precision after the binary point, on vectors of
+up to `vector_size` values, at the `security` level. Every mul, mul_plain,
+dot, matmul_plain or conv2d_im2col consumes one level of depth, and
+polyval_depth() gives the depth of polyval. The first prime keeps between 10
+and 20 bits for the integer part of the values.
+Throws invalid_argument if no poly_modulus_degree up to 32768 can hold the
+parameters.
+*/
+pair<EncryptionParameters, double> select_ckks_parameters(
+    size_t depth, int precision_bits, size_t vector_size,
+    sec_level_type security = sec_level_type::tc128);
+
+/*
+Returns the cheapest EncryptionParameters for the BFV scheme that can evaluate
+`depth` successive ciphertext multiplications on vectors of up to
+`vector_size` values, with a batching plain modulus of `plain_modulus_bits`
+bits, at the `security` level.
+Throws invalid_argument if no poly_modulus_degree up to 32768 can hold the
+parameters.
+*/
+EncryptionParameters select_bfv_parameters(
+    size_t depth, int plain_modulus_bits, size_t vector_size,
+    sec_level_type security = sec_level_type::tc128);
+
 /*
 Returns a SEALContext created with the provided encryption
 parameters.
@@ -1,6 +1,10 @@
 #include "tenseal/cpp/context/tensealcontext.h"
 
+#include <cstring>
+
 #include "seal/seal.h"
+#include "seal/util/numth.h"
+#include "tenseal/cpp/utils/parallel.h"
 #include "tenseal/cpp/utils/proto.h"
 #include "tenseal/cpp/utils/scope.h"
 #include "tenseal/cpp/utils/serialization.h"
@@ -29,21 +33,173 @@ TenSEALContext::TenSEALContext(const TenSEALContextProto& input,
     this->load_proto(input);
 }
 
+TenSEALContext::TenSEALContext(const TenSEALContext& other)
+    : evaluator(other.evaluator),
+      _parms(other._parms),
+      _context(other._context),
+      _public_key(other._public_key),
+      _secret_key(other._secret_key),
+      _relin_keys(other._relin_keys),
+      _galois_keys(std::atomic_load(&other._galois_keys)),
+      _seal_galois_keys(other._seal_galois_keys),
+      encoder_factory(other.encoder_factory->copy()),
+      _seeded_galois_keys(std::atomic_load(&other._seeded_galois_keys)),
+      _seeded_relin_keys(other._seeded_relin_keys),
+      _galois_key_store(std::atomic_load(&other._galois_key_store)),
+      _encryptor(other._encryptor),
+      _decryptor(other._decryptor),
+      _threads(other._threads),
+      _shared_dispatcher(other._shared_dispatcher),
+      _encryption_type(other._encryption_type),
+      _auto_flags(other._auto_flags) {
+    this->_resident_galois_keys = other._resident_galois_keys.load();
+    std::scoped_lock lock{other._dispatcher_mutex};
+    this->_affinity = other._affinity;
+    // a dispatcher owned by the other context isn't shared, the copy creates
+    // its own on first use
+    if (!other._own_dispatcher) this->_dispatcher = other._dispatcher;
+}
+
+namespace {
+std::atomic_bool shared_dispatcher_status = false;
+std::atomic_bool context_registry_status = false;
+
+/**
+ * @returns the Galois elements of the keys, SEAL stores the key of element
+ *"elt" at index (elt - 1) / 2.
+ **/
+vector<uint32_t> galois_key_elts(const GaloisKeys& keys) {
+    vector<uint32_t> elts;
+    for (size_t i = 0; i < keys.data().size(); ++i)
+        if (!keys.data()[i].empty())
+            elts.push_back(static_cast<uint32_t>(2 * i + 1));
+    return elts;
+}
+
+/**
+ * Move the keys of "src" into "dest", replacing the keys of the same Galois
+ *elements.
+ **/
+void merge_galois_keys(GaloisKeys& dest, GaloisKeys& src) {
+    dest.parms_id() = src.parms_id();
+    auto& keys = src.data();
+    if (dest.data().size() < keys.size()) dest.data().resize(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+        if (!keys[i].empty()) dest.data()[i] = std::move(keys[i]);
+}
+}  // namespace
+
 void TenSEALContext::dispatcher_setup(optional<size_t> n_threads) {
     this->_threads = n_threads.value_or(get_concurrency());
     if (this->_threads == 0) this->_threads = get_concurrency();
 
-    this->_dispatcher = make_shared<sync::ThreadPool>(this->_threads);
+    this->_shared_dispatcher = use_shared_dispatcher();
+}
+
+shared_ptr<sync::ThreadPool> TenSEALContext::dispatcher() const {
+    std::scoped_lock lock{this->_dispatcher_mutex};
+    if (!this->_dispatcher) {
+        if (this->_shared_dispatcher) {
+            this->_dispatcher = shared_dispatcher();
+        } else {
+            this->_dispatcher =
+                make_shared<sync::ThreadPool>(this->_threads, this->_affinity);
+            this->_own_dispatcher = true;
+        }
+    }
+    return this->_dispatcher;
+}
+
+shared_ptr<sync::ThreadPool> TenSEALContext::keygen_dispatcher() const {
+    std::scoped_lock lock{this->_dispatcher_mutex};
+    if (this->_dispatcher) return this->_dispatcher;
+    // creating or loading a context doesn't start its own workers, the keys
+    // are generated on the process-wide dispatcher instead
+    return shared_dispatcher();
+}
+
+void TenSEALContext::dispatcher(shared_ptr<sync::ThreadPool> pool) {
+    std::scoped_lock lock{this->_dispatcher_mutex};
+    this->_dispatcher = pool;
+    this->_own_dispatcher = false;
+}
+
+void TenSEALContext::dispatcher_affinity(
+    const sync::ThreadAffinity& affinity) {
+    std::scoped_lock lock{this->_dispatcher_mutex};
+    this->_affinity = affinity;
+    // only the dispatcher owned by this context follows the new placement
+    if (this->_own_dispatcher) {
+        this->_dispatcher = nullptr;
+        this->_own_dispatcher = false;
+    }
+}
+
+shared_ptr<sync::ThreadPool> TenSEALContext::shared_dispatcher() {
+    static auto pool = make_shared<sync::ThreadPool>(get_concurrency());
+    return pool;
+}
+
+vector<size_t> TenSEALContext::dispatcher_memory_usage() const {
+    std::scoped_lock lock{this->_dispatcher_mutex};
+    if (!this->_dispatcher) return {};
+    return this->_dispatcher->memory_usage();
+}
+
+sync::ThreadPoolMetrics TenSEALContext::dispatcher_metrics() const {
+    std::scoped_lock lock{this->_dispatcher_mutex};
+    if (!this->_dispatcher) return {};
+    return this->_dispatcher->metrics();
+}
+
+void TenSEALContext::use_shared_dispatcher(bool status) {
+    shared_dispatcher_status = status;
+}
+
+bool TenSEALContext::use_shared_dispatcher() {
+    return shared_dispatcher_status;
+}
+
+void TenSEALContext::use_context_registry(bool status) {
+    context_registry_status = status;
+}
+
+bool TenSEALContext::use_context_registry() { return context_registry_status; }
+
+void TenSEALContext::clear_context_registry() {
+    ContextRegistry::instance().clear();
+}
+
+void TenSEALContext::context_registry_capacity(size_t capacity) {
+    ContextRegistry::instance().capacity(capacity);
+}
+
+size_t TenSEALContext::context_registry_capacity() {
+    return ContextRegistry::instance().capacity();
 }
 
 void TenSEALContext::base_setup(EncryptionParameters parms) {
     this->_parms = parms;
-    this->_context = make_shared<SEALContext>(this->_parms);
-
-    this->evaluator = make_shared<Evaluator>(*this->_context);
+    if (use_context_registry()) {
+        std::tie(this->_context, this->evaluator) =
+            ContextRegistry::instance().backend(this->_parms);
+    } else {
+        this->_context = make_shared<SEALContext>(this->_parms);
+        this->evaluator = make_shared<Evaluator>(*this->_context);
+    }
     this->encoder_factory = make_shared<TenSEALEncoder>(this->_context);
 }
 
+template <class T>
+shared_ptr<T> TenSEALContext::load_key(const std::string& bytes) const {
+    auto load = [&]() {
+        return make_shared<T>(SEALDeserialize<T>(*this->_context, bytes));
+    };
+    if (use_context_registry())
+        return ContextRegistry::instance().key<T>(bytes, load);
+    return load();
+}
+
 void TenSEALContext::keys_setup_public_key(optional<PublicKey> public_key,
                                            optional<SecretKey> secret_key,
                                            bool generate_key) {
@@ -173,23 +329,73 @@ shared_ptr<Decryptor> TenSEALContext::decryptor() const {
     return this->_decryptor;
 }
 
+shared_ptr<Decryptor> TenSEALContext::decryptor(
+    const shared_ptr<SecretKey>& sk) const {
+    if (sk == nullptr) throw invalid_argument("invalid secret key");
+    if (sk == this->_secret_key && this->_decryptor) return this->_decryptor;
+
+    // the Decryptors of the keys released since the last lookup are dropped
+    // on every lookup, they would hold a copy of the keys otherwise
+    auto lookup = [this, &sk]() -> shared_ptr<Decryptor> {
+        shared_ptr<Decryptor> found = nullptr;
+        for (auto it = this->_decryptors.begin();
+             it != this->_decryptors.end();) {
+            if (it->second.first.expired()) {
+                it = this->_decryptors.erase(it);
+                continue;
+            }
+            if (it->first == sk.get()) found = it->second.second;
+            ++it;
+        }
+        return found;
+    };
+
+    {
+        std::scoped_lock lock{this->_decryptors_mutex};
+        if (auto found = lookup()) return found;
+    }
+
+    auto decryptor = make_shared<Decryptor>(*this->_context, *sk);
+    std::scoped_lock lock{this->_decryptors_mutex};
+    if (auto found = lookup()) return found;
+    this->_decryptors[sk.get()] = {weak_ptr<const SecretKey>(sk), decryptor};
+    return decryptor;
+}
+
 void TenSEALContext::encrypt(const Plaintext& plain,
                              Ciphertext& destination) const {
     switch (this->_encryption_type) {
         case encryption_type::asymmetric:
-            return this->encryptor()->encrypt(plain, destination);
+            return this->encryptor()->encrypt(plain, destination,
+                                              this->memory_pool());
         case encryption_type::symmetric:
-            return this->encryptor()->encrypt_symmetric(plain, destination);
+            return this->encryptor()->encrypt_symmetric(plain, destination,
+                                                        this->memory_pool());
         default:
             throw invalid_argument("invalid encryption type");
     }
 }
+std::string TenSEALContext::encrypt_seeded(const Plaintext& plain,
+                                           Ciphertext& destination) const {
+    if (this->_encryption_type != encryption_type::symmetric) {
+        this->encrypt(plain, destination);
+        return {};
+    }
+    // saved uncompressed, compressing every fresh ciphertext would slow down
+    // the encryption for little gain over the seeded size
+    return SEALSerializeSeeded(
+        *this->_context,
+        this->encryptor()->encrypt_symmetric(plain, this->memory_pool()),
+        destination, compr_mode_type::none);
+}
 void TenSEALContext::encrypt_zero(Ciphertext& destination) const {
     switch (this->_encryption_type) {
         case encryption_type::asymmetric:
-            return this->encryptor()->encrypt_zero(destination);
+            return this->encryptor()->encrypt_zero(destination,
+                                                   this->memory_pool());
         case encryption_type::symmetric:
-            return this->encryptor()->encrypt_zero_symmetric(destination);
+            return this->encryptor()->encrypt_zero_symmetric(
+                destination, this->memory_pool());
         default:
             throw invalid_argument("invalid encryption type");
     }
@@ -198,10 +404,11 @@ void TenSEALContext::encrypt_zero(parms_id_type parms_id,
                                   Ciphertext& destination) const {
     switch (this->_encryption_type) {
         case encryption_type::asymmetric:
-            return this->encryptor()->encrypt_zero(parms_id, destination);
+            return this->encryptor()->encrypt_zero(parms_id, destination,
+                                                   this->memory_pool());
         case encryption_type::symmetric:
-            return this->encryptor()->encrypt_zero_symmetric(parms_id,
-                                                             destination);
+            return this->encryptor()->encrypt_zero_symmetric(
+                parms_id, destination, this->memory_pool());
         default:
             throw invalid_argument("invalid encryption type");
     }
@@ -213,6 +420,9 @@ void TenSEALContext::decrypt(const Ciphertext& encrypted,
 
 void TenSEALContext::decrypt(const SecretKey& sk, const Ciphertext& encrypted,
                              Plaintext& destination) const {
+    if (&sk == this->_secret_key.get() && this->_decryptor)
+        return this->_decryptor->decrypt(encrypted, destination);
+
     Decryptor decryptor = Decryptor(*this->seal_context(), sk);
 
     return decryptor.decrypt(encrypted, destination);
@@ -259,15 +469,156 @@ shared_ptr<RelinKeys> TenSEALContext::relin_keys() const {
 }
 
 bool TenSEALContext::has_galois_key() const {
-    return this->_galois_keys != nullptr;
+    return std::atomic_load(&this->_galois_keys) != nullptr ||
+           std::atomic_load(&this->_galois_key_store) != nullptr;
+}
+
+shared_ptr<GaloisKeys> TenSEALContext::all_galois_keys() const {
+    auto store = std::atomic_load(&this->_galois_key_store);
+    if (store) {
+        auto keys = make_shared<GaloisKeys>();
+        store->load(store->galois_elts(), *keys);
+        return keys;
+    }
+    // the lazy generation may replace the keys concurrently
+    return std::atomic_load(&this->_galois_keys);
 }
 
 shared_ptr<GaloisKeys> TenSEALContext::galois_keys() const {
-    if (this->_galois_keys == nullptr) {
+    auto keys = this->all_galois_keys();
+    if (keys == nullptr) {
         throw invalid_argument(
             "the current context doesn't hold a Galois keys");
     }
-    return this->_galois_keys;
+    return keys;
+}
+
+shared_ptr<GaloisKeys> TenSEALContext::galois_keys(const vector<int>& steps) {
+    auto store = std::atomic_load(&this->_galois_key_store);
+    auto galois_tool = this->_context->key_context_data()->galois_tool();
+
+    vector<uint32_t> elts;
+    for (auto step : steps) {
+        // SEAL doesn't need any key to rotate by zero
+        if (step == 0) continue;
+        auto elt = galois_tool->get_elt_from_step(step);
+        if (!store || store->has_key(elt)) {
+            elts.push_back(elt);
+            continue;
+        }
+        // without the key of the step, SEAL rotates by the steps of its NAF
+        // decomposition
+        for (auto naf_step : util::naf(step))
+            elts.push_back(galois_tool->get_elt_from_step(naf_step));
+    }
+    return this->galois_elt_keys(elts);
+}
+
+shared_ptr<GaloisKeys> TenSEALContext::galois_elt_keys(
+    const vector<uint32_t>& galois_elts) {
+    auto store = std::atomic_load(&this->_galois_key_store);
+    if (!store && (!this->lazy_galois_keys() || this->is_public()))
+        return this->galois_keys();
+
+    auto missing_elts = [&](const shared_ptr<GaloisKeys>& keys) {
+        vector<uint32_t> elts;
+        for (auto elt : galois_elts) {
+            if (keys && keys->has_key(elt)) continue;
+            // the elements missing from the store are left to SEAL
+            if (store && !store->has_key(elt)) continue;
+            if (find(elts.begin(), elts.end(), elt) == elts.end())
+                elts.push_back(elt);
+        }
+        return elts;
+    };
+
+    auto keys = std::atomic_load(&this->_galois_keys);
+    auto elts = missing_elts(keys);
+    if (elts.empty()) {
+        if (keys) return keys;
+        // nothing to load or generate, e.g. for a rotation by zero
+        keys = make_shared<GaloisKeys>();
+        keys->parms_id() = this->_context->key_parms_id();
+        return keys;
+    }
+
+    // loaded or generated outside of the lock: the generation runs on the
+    // dispatcher, where the waiting thread may run a sibling task asking for
+    // the same keys. Concurrent calls may generate some keys twice.
+    vector<std::string> parts;
+    GaloisKeys generated;
+    if (store)
+        store->load(elts, generated);
+    else
+        generated = this->make_galois_keys(*this->_secret_key, elts, parts);
+
+    std::scoped_lock lock{this->_galois_keys_mutex};
+    keys = std::atomic_load(&this->_galois_keys);
+    if (keys && missing_elts(keys).empty()) return keys;
+
+    // the published keys are never modified, running operations keep using
+    // them while the new ones are merged in a copy
+    auto merged =
+        keys ? make_shared<GaloisKeys>(*keys) : make_shared<GaloisKeys>();
+    merge_galois_keys(*merged, generated);
+    if (store) {
+        for (auto elt : elts) {
+            auto it = find(this->_resident_galois_elts.begin(),
+                           this->_resident_galois_elts.end(), elt);
+            if (it != this->_resident_galois_elts.end())
+                this->_resident_galois_elts.erase(it);
+            this->_resident_galois_elts.push_back(elt);
+        }
+        this->evict_galois_keys(*merged, galois_elts);
+    }
+
+    // the seeded form is only complete if the previous keys had one
+    if (keys && !parts.empty()) {
+        auto previous = this->seeded_galois_keys(keys);
+        if (previous)
+            parts.insert(parts.begin(), previous->parts.begin(),
+                         previous->parts.end());
+        else
+            parts.clear();
+    }
+    this->set_galois_keys(merged, std::move(parts));
+    return merged;
+}
+
+void TenSEALContext::evict_galois_keys(GaloisKeys& keys,
+                                       const vector<uint32_t>& requested) {
+    auto resident = galois_key_elts(keys);
+    auto& loaded = this->_resident_galois_elts;
+    // the keys copied from another context aren't tracked, they're released
+    // before the least recently loaded ones
+    vector<uint32_t> order;
+    for (auto elt : resident)
+        if (find(loaded.begin(), loaded.end(), elt) == loaded.end())
+            order.push_back(elt);
+    order.insert(order.end(), loaded.begin(), loaded.end());
+
+    size_t count = resident.size();
+    for (auto elt : order) {
+        if (count <= this->_resident_galois_keys) break;
+        if (find(requested.begin(), requested.end(), elt) != requested.end())
+            continue;
+
+        auto& key = keys.data()[GaloisKeys::get_index(elt)];
+        if (key.empty()) continue;
+        // the key is released from the snapshot being published, operations
+        // running on the previous one keep it until they're done
+        vector<PublicKey>().swap(key);
+        count--;
+        auto it = find(loaded.begin(), loaded.end(), elt);
+        if (it != loaded.end()) loaded.erase(it);
+    }
+}
+
+void TenSEALContext::resident_galois_keys(size_t capacity) {
+    this->_resident_galois_keys = capacity;
+}
+size_t TenSEALContext::resident_galois_keys() const {
+    return this->_resident_galois_keys;
 }
 
 void TenSEALContext::generate_galois_keys() {
@@ -278,16 +629,190 @@ void TenSEALContext::generate_galois_keys() {
 }
 
 void TenSEALContext::generate_galois_keys(const SecretKey& secret_key) {
-    KeyGenerator keygen = KeyGenerator(*this->_context, secret_key);
+    this->create_galois_keys(secret_key, {});
+}
+
+void TenSEALContext::generate_galois_keys(const vector<int>& steps) {
+    if (this->is_public()) {
+        throw invalid_argument("you need to provide a secret_key");
+    }
+    this->generate_galois_keys(*this->_secret_key, steps);
+}
+
+void TenSEALContext::generate_galois_keys(const SecretKey& secret_key,
+                                          const vector<int>& steps) {
+    if (steps.empty()) throw invalid_argument("no rotation steps provided");
+
+    auto galois_tool = this->_context->key_context_data()->galois_tool();
+    this->create_galois_keys(secret_key,
+                             galois_tool->get_elts_from_steps(steps));
+}
+
+void TenSEALContext::create_galois_keys(const SecretKey& secret_key,
+                                        const vector<uint32_t>& galois_elts) {
+    auto elts = galois_elts;
+    if (elts.empty()) {
+        auto galois_tool = this->_context->key_context_data()->galois_tool();
+        elts = galois_tool->get_elts_all();
+    }
+
+    vector<std::string> parts;
+    auto keys = this->make_galois_keys(secret_key, elts, parts);
+    std::atomic_store(&this->_galois_key_store, shared_ptr<GaloisKeyStore>());
+    this->set_galois_keys(make_shared<GaloisKeys>(std::move(keys)),
+                          std::move(parts));
+}
+
+GaloisKeys TenSEALContext::make_galois_keys(
+    const SecretKey& secret_key, const vector<uint32_t>& galois_elts,
+    vector<std::string>& seeded_parts) const {
+    // the symmetric contexts also keep the seeded form of the keys
+    bool seeded = this->_encryption_type == encryption_type::symmetric;
+    using keys_t = pair<GaloisKeys, vector<std::string>>;
+
+    auto generate = [&](size_t start, size_t end) {
+        KeyGenerator keygen = KeyGenerator(*this->_context, secret_key);
+        vector<uint32_t> elts(galois_elts.begin() + start,
+                              galois_elts.begin() + end);
+        keys_t result;
+        if (seeded)
+            result.second.push_back(SEALSerializeSeeded(
+                *this->_context, keygen.create_galois_keys(elts),
+                result.first));
+        else
+            keygen.create_galois_keys(elts, result.first);
+        return result;
+    };
+
+    keys_t result;
+    size_t n_jobs =
+        sync::parallel_jobs(galois_elts.size(), this->dispatcher_size());
+    if (n_jobs == 1) {
+        result = generate(0, galois_elts.size());
+    } else {
+        // the key of each Galois element is sampled independently, every job
+        // uses its own KeyGenerator and the keys are merged at the end
+        result = sync::parallel_reduce(
+            *this->keygen_dispatcher(), galois_elts.size(), n_jobs, keys_t(),
+            generate, [](keys_t& acc, keys_t& part) {
+                merge_galois_keys(acc.first, part.first);
+                for (auto& bytes : part.second)
+                    acc.second.push_back(std::move(bytes));
+            });
+    }
 
-    GaloisKeys gk;
-    keygen.create_galois_keys(gk);
-    this->_galois_keys = make_shared<GaloisKeys>(gk);
+    seeded_parts = std::move(result.second);
+    return std::move(result.first);
+}
+
+void TenSEALContext::set_galois_keys(shared_ptr<GaloisKeys> keys,
+                                     vector<std::string> seeded_parts) {
+    shared_ptr<const SeededGaloisKeys> seeded = nullptr;
+    if (!seeded_parts.empty())
+        seeded = make_shared<const SeededGaloisKeys>(
+            SeededGaloisKeys{keys, std::move(seeded_parts)});
+
+    std::atomic_store(&this->_galois_keys, keys);
+    std::atomic_store(&this->_seeded_galois_keys, seeded);
+}
+
+shared_ptr<const TenSEALContext::SeededGaloisKeys>
+TenSEALContext::seeded_galois_keys(const shared_ptr<GaloisKeys>& keys) const {
+    auto seeded = std::atomic_load(&this->_seeded_galois_keys);
+    if (!seeded || !keys || seeded->keys.lock() != keys) return nullptr;
+    return seeded;
+}
+
+void TenSEALContext::load_public_galois_keys(
+    const TenSEALPublicProto& buffer) {
+    if (!buffer.galois_keys().empty()) {
+        this->generate_galois_keys(buffer.galois_keys());
+        return;
+    }
+    if (buffer.seeded_galois_keys_size() == 0) return;
+
+    // the keys generated by a symmetric context, or read from a store, are
+    // saved in parts, merged back into a single set
+    auto keys = make_shared<GaloisKeys>();
+    for (const auto& part : buffer.seeded_galois_keys()) {
+        auto loaded = SEALDeserialize<GaloisKeys>(*this->_context, part);
+        merge_galois_keys(*keys, loaded);
+    }
+    std::atomic_store(&this->_galois_key_store, shared_ptr<GaloisKeyStore>());
+    this->set_galois_keys(keys);
+}
+
+void TenSEALContext::save_public_galois_keys(TenSEALPublicProto& buffer) const {
+    auto store = std::atomic_load(&this->_galois_key_store);
+    if (store) {
+        for (auto elt : store->galois_elts()) {
+            GaloisKeys part;
+            store->load({elt}, part);
+            buffer.add_seeded_galois_keys(SEALSerialize<GaloisKeys>(part));
+        }
+        return;
+    }
+
+    auto keys = std::atomic_load(&this->_galois_keys);
+    if (!keys) return;
+    // the keys generated by a symmetric context are saved in their seeded form
+    auto seeded = this->seeded_galois_keys(keys);
+    if (seeded) {
+        for (const auto& part : seeded->parts)
+            buffer.add_seeded_galois_keys(part);
+    } else {
+        *buffer.mutable_galois_keys() = SEALSerialize<GaloisKeys>(*keys);
+    }
+}
+
+void TenSEALContext::load_private_galois_keys(
+    const TenSEALPrivateProto& buffer) {
+    if (!buffer.galois_keys_generated() || this->is_public()) return;
+
+    this->create_galois_keys(
+        *this->_secret_key,
+        {buffer.galois_elts().begin(), buffer.galois_elts().end()});
+}
+
+void TenSEALContext::save_private_galois_keys(
+    TenSEALPrivateProto& buffer) const {
+    // only the elements are saved, the stored keys aren't loaded
+    auto store = std::atomic_load(&this->_galois_key_store);
+    auto keys = std::atomic_load(&this->_galois_keys);
+    buffer.set_galois_keys_generated(store != nullptr || keys != nullptr);
+
+    if (!store && !keys) return;
+
+    for (auto elt : store ? store->galois_elts() : galois_key_elts(*keys))
+        buffer.add_galois_elts(elt);
 }
 
 void TenSEALContext::generate_galois_keys(const std::string& bytes) {
-    this->_galois_keys = make_shared<GaloisKeys>(
-        SEALDeserialize<GaloisKeys>(*this->_context, bytes));
+    std::atomic_store(&this->_galois_key_store, shared_ptr<GaloisKeyStore>());
+    this->set_galois_keys(this->load_key<GaloisKeys>(bytes));
+}
+
+void TenSEALContext::store_galois_keys(const std::string& path) {
+    // the store already holds all the keys
+    auto current = std::atomic_load(&this->_galois_key_store);
+    if (current && current->path() == path) return;
+
+    auto keys = this->galois_keys();
+    auto store = GaloisKeyStore::Create(path, this->_context, *keys);
+
+    std::scoped_lock lock{this->_galois_keys_mutex};
+    std::atomic_store(&this->_galois_key_store, store);
+    this->_resident_galois_elts.clear();
+    this->set_galois_keys(nullptr);
+}
+
+void TenSEALContext::load_galois_keys(const std::string& path) {
+    auto store = GaloisKeyStore::Open(path, this->_context);
+
+    std::scoped_lock lock{this->_galois_keys_mutex};
+    std::atomic_store(&this->_galois_key_store, store);
+    this->_resident_galois_elts.clear();
+    this->set_galois_keys(nullptr);
 }
 
 void TenSEALContext::generate_relin_keys() {
@@ -300,15 +825,21 @@ void TenSEALContext::generate_relin_keys() {
 void TenSEALContext::generate_relin_keys(const SecretKey& secret_key) {
     KeyGenerator keygen = KeyGenerator(*this->_context, secret_key);
 
-    RelinKeys rk;
-    keygen.create_relin_keys(rk);
+    auto rk = make_shared<RelinKeys>();
+    shared_ptr<const std::string> seeded = nullptr;
+    if (this->_encryption_type == encryption_type::symmetric)
+        seeded = make_shared<const std::string>(SEALSerializeSeeded(
+            *this->_context, keygen.create_relin_keys(), *rk));
+    else
+        keygen.create_relin_keys(*rk);
 
-    this->_relin_keys = make_shared<RelinKeys>(rk);
+    this->_relin_keys = rk;
+    this->_seeded_relin_keys = seeded;
 }
 
 void TenSEALContext::generate_relin_keys(const std::string& bytes) {
-    this->_relin_keys = make_shared<RelinKeys>(
-        SEALDeserialize<RelinKeys>(*this->_context, bytes));
+    this->_relin_keys = this->load_key<RelinKeys>(bytes);
+    this->_seeded_relin_keys = nullptr;
 }
 
 void TenSEALContext::make_context_public(bool generate_galois_keys,
@@ -332,7 +863,7 @@ void TenSEALContext::make_context_public(bool generate_galois_keys,
     }
 
     // generate Galois Keys
-    if (generate_galois_keys && this->_galois_keys == nullptr) {
+    if (generate_galois_keys && !this->has_galois_key()) {
         this->generate_galois_keys();
     }
 
@@ -365,6 +896,19 @@ double TenSEALContext::safe_global_scale() const {
     return scale;
 }
 
+void TenSEALContext::encode_cache_capacity(size_t capacity) {
+    encoder_factory->encode_cache()->capacity(capacity);
+}
+size_t TenSEALContext::encode_cache_capacity() const {
+    return encoder_factory->encode_cache()->capacity();
+}
+EncodeCacheStats TenSEALContext::encode_cache_stats() const {
+    return encoder_factory->encode_cache()->stats();
+}
+void TenSEALContext::clear_encode_cache() {
+    encoder_factory->encode_cache()->clear();
+}
+
 void TenSEALContext::auto_relin(bool status) {
     if (is_public()) return;
 
@@ -391,6 +935,14 @@ void TenSEALContext::auto_mod_switch(bool status) {
     this->_auto_flags |= flag;
 }
 
+void TenSEALContext::lazy_galois_keys(bool status) {
+    uint8_t flag = uint8_t(status) << 3;
+    // switch it off
+    this->_auto_flags &= ~flag_lazy_galois_keys;
+    // set it to status
+    this->_auto_flags |= flag;
+}
+
 bool TenSEALContext::auto_relin() const {
     return this->_auto_flags & flag_auto_relin;
 }
@@ -400,13 +952,66 @@ bool TenSEALContext::auto_rescale() const {
 bool TenSEALContext::auto_mod_switch() const {
     return this->_auto_flags & flag_auto_mod_switch;
 }
+bool TenSEALContext::lazy_galois_keys() const {
+    return this->_auto_flags & flag_lazy_galois_keys;
+}
 
 bool TenSEALContext::equals(
     const std::shared_ptr<TenSEALContext>& other) const {
-    // TODO: improve checks
+    if (this == other.get()) return true;
     if (this->safe_global_scale() != other->safe_global_scale()) return false;
+    if (this->_context->key_parms_id() != other->_context->key_parms_id())
+        return false;
+
+    // the ciphertexts are bound to the secret key, which the public contexts
+    // only hold through the public key. The evaluation keys aren't compared,
+    // they are regenerated when a private context is loaded
+    auto& registry = ContextRegistry::instance();
+    if (this->_secret_key && other->_secret_key)
+        return registry.key_digest(this->_secret_key) ==
+               registry.key_digest(other->_secret_key);
+    if (this->_public_key && other->_public_key)
+        return registry.key_digest(this->_public_key) ==
+               registry.key_digest(other->_public_key);
+    // without comparable keys, nothing tells that the secret key is shared
+    return false;
+}
 
-    return true;
+digest_t TenSEALContext::fingerprint() const {
+    auto& registry = ContextRegistry::instance();
+    auto parms_id = this->_context->key_parms_id();
+    vector<uint64_t> words(parms_id.begin(), parms_id.end());
+
+    double scale = this->safe_global_scale();
+    uint64_t scale_bits;
+    std::memcpy(&scale_bits, &scale, sizeof(scale));
+    words.push_back(to_underlying(this->_encryption_type));
+    words.push_back(this->_auto_flags);
+    words.push_back(scale_bits);
+
+    auto add_key = [&](const auto& key) {
+        words.push_back(key != nullptr);
+        if (!key) return;
+        auto value = registry.key_digest(key);
+        words.insert(words.end(), value.begin(), value.end());
+    };
+    add_key(this->_public_key);
+    add_key(this->_secret_key);
+    add_key(this->_relin_keys);
+    // the digest of a store is read from its header, it matches the digest
+    // of the keys it was created from
+    auto store = std::atomic_load(&this->_galois_key_store);
+    if (store) {
+        words.push_back(1);
+        words.insert(words.end(), store->keys_digest().begin(),
+                     store->keys_digest().end());
+    } else {
+        add_key(std::atomic_load(&this->_galois_keys));
+    }
+
+    digest_t result;
+    util::HashFunction::hash(words.data(), words.size(), result);
+    return result;
 }
 
 void TenSEALContext::load_proto_public_key(const TenSEALContextProto& buffer) {
@@ -417,20 +1022,18 @@ void TenSEALContext::load_proto_public_key(const TenSEALContextProto& buffer) {
         this->global_scale(buffer.public_context().scale());
     }
 
-    optional<PublicKey> public_key = {};
-    if (!buffer.public_context().public_key().empty()) {
-        public_key = SEALDeserialize<PublicKey>(
-            *this->_context, buffer.public_context().public_key());
-    }
+    // the interned public key is shared, not copied, and its encryptor is
+    // set up by keys_setup
+    if (!buffer.public_context().public_key().empty())
+        this->_public_key =
+            this->load_key<PublicKey>(buffer.public_context().public_key());
 
     if (!buffer.has_private_context()) {
-        this->keys_setup(encryption_type::asymmetric, public_key, {},
+        this->keys_setup(encryption_type::asymmetric, {}, {},
                          /*generate_relin_keys=*/false,
                          /*generate_galois_keys=*/false,
                          /*generate_secret_key=*/false);
-        if (!buffer.public_context().galois_keys().empty()) {
-            this->generate_galois_keys(buffer.public_context().galois_keys());
-        }
+        this->load_public_galois_keys(buffer.public_context());
         if (!buffer.public_context().relin_keys().empty()) {
             this->generate_relin_keys(buffer.public_context().relin_keys());
         }
@@ -442,9 +1045,10 @@ void TenSEALContext::load_proto_public_key(const TenSEALContextProto& buffer) {
         secret_key = SEALDeserialize<SecretKey>(
             *this->_context, buffer.private_context().secret_key());
     }
-    this->keys_setup(encryption_type::asymmetric, public_key, secret_key,
+    this->keys_setup(encryption_type::asymmetric, {}, secret_key,
                      buffer.private_context().relin_keys_generated(),
-                     buffer.private_context().galois_keys_generated(), false);
+                     /*generate_galois_keys=*/false, false);
+    this->load_private_galois_keys(buffer.private_context());
 }
 
 void TenSEALContext::load_proto_symmetric(const TenSEALContextProto& buffer) {
@@ -460,16 +1064,14 @@ void TenSEALContext::load_proto_symmetric(const TenSEALContextProto& buffer) {
             *this->_context, buffer.private_context().secret_key());
         this->keys_setup(encryption_type::symmetric, {}, secret_key,
                          buffer.private_context().relin_keys_generated(),
-                         buffer.private_context().galois_keys_generated(),
-                         false);
+                         /*generate_galois_keys=*/false, false);
+        this->load_private_galois_keys(buffer.private_context());
     } else {
         this->keys_setup(encryption_type::symmetric, {}, {},
                          /*generate_relin_keys=*/false,
                          /*               generate_galois_keys=*/false,
                          /*generate_secret_key=*/false);
-        if (!buffer.public_context().galois_keys().empty()) {
-            this->generate_galois_keys(buffer.public_context().galois_keys());
-        }
+        this->load_public_galois_keys(buffer.public_context());
         if (!buffer.public_context().relin_keys().empty()) {
             this->generate_relin_keys(buffer.public_context().relin_keys());
         }
@@ -507,9 +1109,7 @@ TenSEALContextProto TenSEALContext::save_proto_public_key(
     }
 
     if (this->is_public() || !save_secret_key) {
-        if (save_galois_keys && this->_galois_keys)
-            *public_buffer.mutable_galois_keys() =
-                SEALSerialize<GaloisKeys>(*this->_galois_keys);
+        if (save_galois_keys) this->save_public_galois_keys(public_buffer);
         if (save_relin_keys && this->_relin_keys)
             *public_buffer.mutable_relin_keys() =
                 SEALSerialize<RelinKeys>(*this->_relin_keys);
@@ -526,8 +1126,7 @@ TenSEALContextProto TenSEALContext::save_proto_public_key(
     *private_buffer.mutable_secret_key() =
         SEALSerialize<SecretKey>(*this->secret_key());
 
-    if (save_galois_keys)
-        private_buffer.set_galois_keys_generated(this->_galois_keys != nullptr);
+    if (save_galois_keys) this->save_private_galois_keys(private_buffer);
     if (save_relin_keys)
         private_buffer.set_relin_keys_generated(this->_relin_keys != nullptr);
 
@@ -549,12 +1148,12 @@ TenSEALContextProto TenSEALContext::save_proto_symmetric(
     public_buffer.set_scale(this->safe_global_scale());
 
     if (!save_secret_key) {
-        if (save_galois_keys && this->_galois_keys)
-            *public_buffer.mutable_galois_keys() =
-                SEALSerialize<GaloisKeys>(*this->_galois_keys);
+        if (save_galois_keys) this->save_public_galois_keys(public_buffer);
         if (save_relin_keys && this->_relin_keys)
             *public_buffer.mutable_relin_keys() =
-                SEALSerialize<RelinKeys>(*this->_relin_keys);
+                this->_seeded_relin_keys
+                    ? *this->_seeded_relin_keys
+                    : SEALSerialize<RelinKeys>(*this->_relin_keys);
     }
 
     *buffer.mutable_public_context() = public_buffer;
@@ -566,8 +1165,7 @@ TenSEALContextProto TenSEALContext::save_proto_symmetric(
     TenSEALPrivateProto private_buffer;
     *private_buffer.mutable_secret_key() =
         SEALSerialize<SecretKey>(*this->secret_key());
-    if (save_galois_keys)
-        private_buffer.set_galois_keys_generated(this->_galois_keys != nullptr);
+    if (save_galois_keys) this->save_private_galois_keys(private_buffer);
     if (save_relin_keys)
         private_buffer.set_relin_keys_generated(this->_relin_keys != nullptr);
 
@@ -594,11 +1192,7 @@ TenSEALContextProto TenSEALContext::save_proto(bool save_public_key,
 }
 
 std::shared_ptr<TenSEALContext> TenSEALContext::copy() const {
-    TenSEALContextProto buffer =
-        this->save_proto(/*save_public_key=*/true, /*save_secret_key=*/true,
-                         /*save_galois_keys=*/true, /*save_relin_keys=*/true);
-    return shared_ptr<TenSEALContext>(
-        new TenSEALContext(buffer, this->_threads));
+    return shared_ptr<TenSEALContext>(new TenSEALContext(*this));
 }
 
 void TenSEALContext::load(const std::string& input) {
@@ -701,7 +1295,8 @@ std::vector<std::vector<std::vector<std::vector<uint64_t>>>> TenSEALContext::get
 
 std::vector<std::vector<std::vector<uint64_t>>> TenSEALContext::get_galois_key_values() const{
     std::vector<std::vector<std::vector<uint64_t>>> result;
-    const auto& galois_keys = this->galois_keys()->data();  // std::unordered_map<uint32_t, std::vector<PublicKey>>
+    auto keys = this->galois_keys();
+    const auto& galois_keys = keys->data();  // std::unordered_map<uint32_t, std::vector<PublicKey>>
 
     for (const auto& key_vec : galois_keys) {
         // const auto& key_vec = key_pair.second;
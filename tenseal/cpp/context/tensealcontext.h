@@ -1,7 +1,11 @@
 #ifndef TENSEAL_CONTEXT_TENSEALCONTEXT_H
 #define TENSEAL_CONTEXT_TENSEALCONTEXT_H
 
+#include <deque>
+
 #include "seal/seal.h"
+#include "tenseal/cpp/context/galois_key_store.h"
+#include "tenseal/cpp/context/registry.h"
 #include "tenseal/cpp/context/sealcontext.h"
 #include "tenseal/cpp/context/tensealencoder.h"
 #include "tenseal/cpp/utils/helpers.h"
@@ -96,10 +100,26 @@ class TenSEALContext {
      **/
     shared_ptr<RelinKeys> relin_keys() const;
     /**
-     * @returns a pointer to the Galois keys.
+     * @returns a pointer to the Galois keys. With a key store, all the keys
+     *are deserialized from the file on every call, without being kept in the
+     *context.
      * @throws invalid_argument if the keys are missing.
      **/
     shared_ptr<GaloisKeys> galois_keys() const;
+    /**
+     * @returns a pointer to Galois keys covering the rotation "steps". With
+     *a key store, the missing keys are loaded from the file first. With lazy
+     *Galois keys and a secret key, they are generated. In both cases, they
+     *are then kept in memory by the context, until its Galois keys are
+     *replaced, or until they're released past resident_galois_keys() for
+     *the loaded ones.
+     * @throws invalid_argument if the keys are missing.
+     **/
+    shared_ptr<GaloisKeys> galois_keys(const vector<int>& steps);
+    /**
+     * Same as galois_keys(steps), for a set of Galois elements.
+     **/
+    shared_ptr<GaloisKeys> galois_elt_keys(const vector<uint32_t>& galois_elts);
     /**
      * Generate Galois keys using the existing secret key.
      * @throws invalid_argument if the context is public.
@@ -110,11 +130,49 @@ class TenSEALContext {
      * @param[in] secret_key.
      **/
     void generate_galois_keys(const SecretKey& secret_key);
+    /**
+     * Generate Galois keys for a set of rotation steps only, using the
+     *existing secret key. Rotations by other steps fail, unless SEAL can
+     *decompose them into the generated steps.
+     * @param[in] steps: rotation steps, negative steps rotate to the right.
+     * @throws invalid_argument if the context is public, or if a step is
+     *invalid.
+     **/
+    void generate_galois_keys(const vector<int>& steps);
+    /**
+     * Generate Galois keys for a set of rotation steps, using a custom secret
+     *key.
+     **/
+    void generate_galois_keys(const SecretKey& secret_key,
+                              const vector<int>& steps);
     /**
      * Generate Galois keys from a serialized protobuffer.
      * @param[in] input: Serialized string.
      **/
     void generate_galois_keys(const std::string&);
+    /**
+     * Move the Galois keys to a GaloisKeyStore file at "path". The keys are
+     *then released from memory, and an operation only loads the keys of the
+     *rotation steps it uses.
+     * @throws invalid_argument if the keys are missing, or if the file can't
+     *be written.
+     **/
+    void store_galois_keys(const std::string& path);
+    /**
+     * Use the Galois keys of an existing GaloisKeyStore file, replacing the
+     *current keys.
+     * @throws invalid_argument if the file isn't a store for the parameters
+     *of this context.
+     **/
+    void load_galois_keys(const std::string& path);
+    /**
+     * Set the number of Galois elements whose keys stay in memory once
+     *loaded from the GaloisKeyStore. The least recently loaded keys are
+     *released first, the keys used by the current operation are always kept.
+     * @param[in] capacity: the maximum number of resident Galois elements.
+     **/
+    void resident_galois_keys(size_t capacity);
+    size_t resident_galois_keys() const;
     /**
      * Generate Relinearization keys using the existing secret key.
      * @throws invalid_argument if the context is public.
@@ -156,10 +214,26 @@ class TenSEALContext {
      **/
     shared_ptr<Encryptor> encryptor() const;
     shared_ptr<Decryptor> decryptor() const;
+    /**
+     * @returns a Decryptor for "sk". The Decryptors are cached per secret key
+     *object for as long as the key is alive, so decrypting many ciphertexts
+     *with the same key only sets it up once. The Decryptors of the released
+     *keys are dropped on the next call.
+     **/
+    shared_ptr<Decryptor> decryptor(const shared_ptr<SecretKey>& sk) const;
     /**
      * Encrypt a Plaintext to a Ciphertext
      * */
     void encrypt(const Plaintext& plain, Ciphertext& destination) const;
+    /**
+     * Encrypt a Plaintext to a Ciphertext, and keep the seeded serialization
+     *of the symmetric ciphertexts, where the second polynomial is replaced by
+     *the seed it was sampled from.
+     * @returns the seeded serialization, or an empty string for the
+     *asymmetric contexts.
+     **/
+    std::string encrypt_seeded(const Plaintext& plain,
+                               Ciphertext& destination) const;
     void encrypt_zero(Ciphertext& destination) const;
     void encrypt_zero(parms_id_type parms_id, Ciphertext& destination) const;
     /**
@@ -175,6 +249,13 @@ class TenSEALContext {
     void encode(Args&&... args) const {
         encoder_factory->encode<T>(std::forward<Args>(args)...);
     }
+    /**
+     * Encode a vector replicated over all the slots, without copying it.
+     **/
+    template <typename T, typename... Args>
+    void encode_replicated(Args&&... args) const {
+        encoder_factory->encode_replicated<T>(std::forward<Args>(args)...);
+    }
     /**
      * Template decoder function for the encoders.
      **/
@@ -203,6 +284,22 @@ class TenSEALContext {
      * Get the global scale for the CKKS scheme.
      **/
     double safe_global_scale() const;
+    /**
+     * Set the number of plaintexts kept by the encode cache, which spares
+     *encoding the same plain operands again at the same scale and level, 0
+     *disabling it. The cache is shared with the copies of the context.
+     * @param[in] capacity: the maximum number of cached plaintexts.
+     **/
+    void encode_cache_capacity(size_t capacity);
+    size_t encode_cache_capacity() const;
+    /**
+     * @returns the hit and miss counters of the encode cache.
+     **/
+    EncodeCacheStats encode_cache_stats() const;
+    /**
+     * Release the plaintexts of the encode cache and reset its counters.
+     **/
+    void clear_encode_cache();
     /**
      * Switch on/off automatic relinearization, rescaling, and mod switching.
      * @param[in] status: on/off.
@@ -217,6 +314,14 @@ class TenSEALContext {
     bool auto_relin() const;
     bool auto_rescale() const;
     bool auto_mod_switch() const;
+    /**
+     * Switch on/off the lazy generation of the Galois keys. When on, and as
+     *long as the context holds a secret key, the key of a rotation step is
+     *only generated the first time an operation rotates by it.
+     * @param[in] status: on/off.
+     **/
+    void lazy_galois_keys(bool status);
+    bool lazy_galois_keys() const;
     /**
      * Populate the current context from a serialized protobuffer.
      * @param[in] input serialized protobuffer.
@@ -229,7 +334,10 @@ class TenSEALContext {
     std::string save(bool save_public_key, bool save_secret_key,
                      bool save_galois_keys, bool save_relin_keys) const;
     /**
-     * @returns a deepcopy of the current context.
+     * @returns a copy of the current context. The parameters, the keys and
+     *the encoders are shared with the copy, only the settings (scale, flags,
+     *dispatcher) are duplicated. The keys are never modified in place, a
+     *context replacing its keys leaves the other copies untouched.
      **/
     std::shared_ptr<TenSEALContext> copy() const;
     /**
@@ -245,14 +353,102 @@ class TenSEALContext {
     const EncryptionParameters& parms() const { return _parms; }
     const encryption_type enc_type() const { return _encryption_type; }
     /**
-     * @returns true if the contexts are identical.
+     * @returns true if the contexts can operate on the same ciphertexts: they
+     *share the encryption parameters, the global scale and the key material.
+     *The secret keys are compared first, then the public keys. The Galois
+     *and Relinearization keys aren't compared, as every private context
+     *regenerates its own. Contexts without comparable keys aren't equal.
      **/
     bool equals(const std::shared_ptr<TenSEALContext>& other) const;
     /**
-     * @returns a pointer to the threadpool dispatcher
+     * @returns a digest of the whole content of the context: parameters,
+     *encryption type, global scale, flags and keys. The digests of the keys
+     *are computed once per key object.
+     **/
+    digest_t fingerprint() const;
+    /**
+     * @returns a pointer to the threadpool dispatcher. The dispatcher is
+     *created on first use, so contexts which never run a parallel operation
+     *spawn no threads.
+     **/
+    shared_ptr<sync::ThreadPool> dispatcher() const;
+    /**
+     * Attach the context to an existing dispatcher, which can be shared by
+     *many contexts. Passing nullptr detaches it, and a new dispatcher will be
+     *created on the next use.
+     * @param[in] pool: the threadpool to use for parallel operations.
+     **/
+    void dispatcher(shared_ptr<sync::ThreadPool> pool);
+    /**
+     * Pin the workers of the context's own dispatcher to a set of CPUs, e.g.
+     *sync::numa_node_affinity(node) to bind the context to one socket. The
+     *ciphertexts encrypted or deserialized by the workers are then allocated
+     *on that node. A dispatcher already created by the context is replaced on
+     *the next use, a shared or attached dispatcher is left as is.
+     * @param[in] affinity: the placement of the workers.
+     **/
+    void dispatcher_affinity(const sync::ThreadAffinity& affinity);
+    const sync::ThreadAffinity& dispatcher_affinity() const {
+        return _affinity;
+    }
+    /**
+     * @returns the maximum number of parallel jobs an operation on this
+     *context can dispatch.
      **/
-    shared_ptr<sync::ThreadPool> dispatcher() const { return _dispatcher; }
     size_t dispatcher_size() const { return _threads; }
+    /**
+     * @returns the memory pool of the calling dispatcher worker, or the global
+     *SEAL memory pool outside of the dispatcher.
+     **/
+    MemoryPoolHandle memory_pool() const {
+        return sync::ThreadPool::memory_pool();
+    }
+    /**
+     * @returns the number of bytes allocated by the memory pool of each
+     *dispatcher worker, or an empty vector if the dispatcher wasn't created
+     *yet.
+     **/
+    vector<size_t> dispatcher_memory_usage() const;
+    /**
+     * @returns the queue depths, task counters and latency histograms of the
+     *dispatcher, or empty metrics if the dispatcher wasn't created yet. With
+     *a shared dispatcher, they cover the tasks of all the contexts using it.
+     **/
+    sync::ThreadPoolMetrics dispatcher_metrics() const;
+    /**
+     * @returns the process-wide dispatcher, created with get_concurrency()
+     *threads on first use.
+     **/
+    static shared_ptr<sync::ThreadPool> shared_dispatcher();
+    /**
+     * Switch on/off the use of the process-wide dispatcher by the contexts
+     *created afterwards. When off, every new context lazily creates its own
+     *dispatcher with n_threads workers.
+     * @param[in] status: on/off.
+     **/
+    static void use_shared_dispatcher(bool status);
+    static bool use_shared_dispatcher();
+    /**
+     * Switch on/off the use of the process-wide ContextRegistry by the
+     *contexts created or loaded afterwards. When on, the contexts with the
+     *same encryption parameters share their SEALContext and Evaluator, and
+     *the public keys loaded from identical buffers are deserialized once.
+     * @param[in] status: on/off.
+     **/
+    static void use_context_registry(bool status);
+    static bool use_context_registry();
+    /**
+     * Release everything interned by the ContextRegistry. The contexts
+     *already using it are left untouched.
+     **/
+    static void clear_context_registry();
+    /**
+     * Set the number of recently used SEALContexts and keys the
+     *ContextRegistry keeps once the contexts using them are released, so
+     *that the next identical context loaded reuses them.
+     **/
+    static void context_registry_capacity(size_t capacity);
+    static size_t context_registry_capacity();
 
     /**
      * @return whether a context has the key in question present.
@@ -274,14 +470,42 @@ class TenSEALContext {
     shared_ptr<SecretKey> _secret_key = nullptr;
     shared_ptr<RelinKeys> _relin_keys = nullptr;
     shared_ptr<GaloisKeys> _galois_keys = nullptr;
+    // serializes the lazy generation of the Galois keys
+    std::mutex _galois_keys_mutex;
     std::shared_ptr<seal::GaloisKeys> _seal_galois_keys;
     shared_ptr<TenSEALEncoder> encoder_factory = nullptr;
+    /**
+     * Seeded serializations of the keys generated by a symmetric context,
+     *saved instead of the expanded keys, at half their size. The Galois keys
+     *are generated in several parts, one per job.
+     **/
+    struct SeededGaloisKeys {
+        weak_ptr<GaloisKeys> keys;
+        vector<std::string> parts;
+    };
+    shared_ptr<const SeededGaloisKeys> _seeded_galois_keys = nullptr;
+    shared_ptr<const std::string> _seeded_relin_keys = nullptr;
+    // backs the Galois keys, which are then loaded on first use
+    shared_ptr<GaloisKeyStore> _galois_key_store = nullptr;
+    // the Galois elements loaded from the store, the oldest first, guarded
+    // by _galois_keys_mutex
+    std::deque<uint32_t> _resident_galois_elts;
+    std::atomic<size_t> _resident_galois_keys{32};
 
     shared_ptr<Encryptor> _encryptor = nullptr;
     shared_ptr<Decryptor> _decryptor = nullptr;
-    shared_ptr<sync::ThreadPool> _dispatcher = nullptr;
+    // Decryptors of the secret keys provided by the callers
+    mutable map<const SecretKey*,
+                pair<weak_ptr<const SecretKey>, shared_ptr<Decryptor>>>
+        _decryptors;
+    mutable std::mutex _decryptors_mutex;
+    mutable shared_ptr<sync::ThreadPool> _dispatcher = nullptr;
+    mutable std::mutex _dispatcher_mutex;
+    mutable bool _own_dispatcher = false;
 
     size_t _threads;
+    bool _shared_dispatcher;
+    sync::ThreadAffinity _affinity;
     encryption_type _encryption_type;
 
     /**
@@ -291,6 +515,7 @@ class TenSEALContext {
         flag_auto_relin = 1 << 0,
         flag_auto_rescale = 1 << 1,
         flag_auto_mod_switch = 1 << 2,
+        flag_lazy_galois_keys = 1 << 3,
     };
     uint8_t _auto_flags =
         flag_auto_relin | flag_auto_rescale | flag_auto_mod_switch;
@@ -301,6 +526,7 @@ class TenSEALContext {
     TenSEALContext(const std::string& stream, optional<size_t> n_threads);
     TenSEALContext(const TenSEALContextProto& proto,
                    optional<size_t> n_threads);
+    TenSEALContext(const TenSEALContext& other);
 
     void base_setup(EncryptionParameters);
     void dispatcher_setup(optional<size_t> n_threads);
@@ -315,6 +541,63 @@ class TenSEALContext {
                                bool generate_secret_key = true);
     void keys_setup_symmetric(optional<SecretKey> secret_key = {},
                               bool generate_secret_key = true);
+    /**
+     * Deserialize a public key, through the ContextRegistry if it's used.
+     **/
+    template <class T>
+    shared_ptr<T> load_key(const std::string& bytes) const;
+    /**
+     * Generate the Galois keys for a list of Galois elements, or for all the
+     *power of two steps if empty.
+     **/
+    void create_galois_keys(const SecretKey& secret_key,
+                            const vector<uint32_t>& galois_elts);
+    /**
+     * @returns the dispatcher of the context if it was already created, the
+     *process-wide dispatcher otherwise.
+     **/
+    shared_ptr<sync::ThreadPool> keygen_dispatcher() const;
+    /**
+     * Generate the Galois keys for a list of Galois elements, spreading the
+     *elements over the dispatcher of the context, or over the process-wide
+     *one if the context didn't create its own yet.
+     **/
+    GaloisKeys make_galois_keys(const SecretKey& secret_key,
+                                const vector<uint32_t>& galois_elts,
+                                vector<std::string>& seeded_parts) const;
+    /**
+     * Publish new Galois keys, along with the seeded parts they merge, if
+     *any.
+     **/
+    void set_galois_keys(shared_ptr<GaloisKeys> keys,
+                         vector<std::string> seeded_parts = {});
+    /**
+     * Release the keys loaded from the store beyond the resident capacity,
+     *except the keys of "requested". Called under _galois_keys_mutex.
+     **/
+    void evict_galois_keys(GaloisKeys& keys, const vector<uint32_t>& requested);
+    /**
+     * @returns all the Galois keys, loaded from the key store if there is
+     *one, nullptr if the keys are missing.
+     **/
+    shared_ptr<GaloisKeys> all_galois_keys() const;
+    /**
+     * Load/Save the Galois keys of a public protobuffer. The keys of a store
+     *are saved one Galois element at a time, as parts to be merged, so they're
+     *never all loaded together.
+     **/
+    void load_public_galois_keys(const TenSEALPublicProto& buffer);
+    void save_public_galois_keys(TenSEALPublicProto& buffer) const;
+    /**
+     * @returns the seeded parts of "keys", nullptr if they aren't kept.
+     **/
+    shared_ptr<const SeededGaloisKeys> seeded_galois_keys(
+        const shared_ptr<GaloisKeys>& keys) const;
+    /**
+     * Load/Save the Galois keys flag and elements of a private context.
+     **/
+    void load_private_galois_keys(const TenSEALPrivateProto& buffer);
+    void save_private_galois_keys(TenSEALPrivateProto& buffer) const;
     /**
      * Load/Save a protobuffer for the current context.
      **/
@@ -1,6 +1,7 @@
 #ifndef TENSEAL_CONTEXT_TENSEALENCODER_H
 #define TENSEAL_CONTEXT_TENSEALENCODER_H
 
+#include <algorithm>
 #include <any>
 #include <map>
 #include <optional>
@@ -10,6 +11,8 @@
 
 #include "gsl/span"
 #include "seal/seal.h"
+#include "tenseal/cpp/context/encode_cache.h"
+#include "tenseal/cpp/utils/threadpool.h"
 
 namespace tenseal {
 
@@ -23,6 +26,20 @@ class TenSEALEncoder {
     TenSEALEncoder(const shared_ptr<SEALContext>& context)
         : _context(context){};
 
+    /*
+    Returns a new factory sharing the encoders and the encode cache, with its
+    own global scale.
+    */
+    shared_ptr<TenSEALEncoder> copy() {
+        auto factory = make_shared<TenSEALEncoder>(this->_context);
+
+        std::shared_lock lock(mutex_);
+        factory->_encoders = this->_encoders;
+        factory->_encode_cache = this->_encode_cache;
+        factory->_scale = this->_scale;
+        return factory;
+    }
+
     template <typename T>
     shared_ptr<T> get() {
         const type_index& tidx = type_index(typeid(T));
@@ -69,19 +86,79 @@ class TenSEALEncoder {
     void encode(const gsl::span<const double>& vec, Plaintext& pt,
                 optional<double> optscale = {}) {
         auto encoder = this->get<CKKSEncoder>();
-        encoder->encode(vec, unwrap_scale(optscale), pt);
+        encoder->encode(vec, unwrap_scale(optscale), pt,
+                        sync::ThreadPool::memory_pool());
     }
     template <class CKKSEncoder>
     void encode(const vector<double>& vec, Plaintext& pt,
                 optional<double> optscale = {}) {
         auto encoder = this->get<CKKSEncoder>();
-        encoder->encode(vec, unwrap_scale(optscale), pt);
+        encoder->encode(vec, unwrap_scale(optscale), pt,
+                        sync::ThreadPool::memory_pool());
+    }
+
+    /*
+    Encode `vec` at `parms_id` rather than at the top of the modulus chain,
+    going through the encode cache when it's enabled.
+    */
+    template <class CKKSEncoder>
+    void encode(const gsl::span<const double>& vec, Plaintext& pt,
+                optional<double> optscale, const parms_id_type& parms_id) {
+        auto encoder = this->get<CKKSEncoder>();
+        double scale = unwrap_scale(optscale);
+        if (!_encode_cache->enabled()) {
+            encoder->encode(vec, parms_id, scale, pt,
+                            sync::ThreadPool::memory_pool());
+            return;
+        }
+
+        auto key = EncodeCache::key(vec, scale, parms_id);
+        if (_encode_cache->find(key, pt)) return;
+        encoder->encode(vec, parms_id, scale, pt,
+                        sync::ThreadPool::memory_pool());
+        _encode_cache->insert(key, pt);
+    }
+    template <class CKKSEncoder>
+    void encode(const vector<double>& vec, Plaintext& pt,
+                optional<double> optscale, const parms_id_type& parms_id) {
+        this->encode<CKKSEncoder>(gsl::span<const double>(vec), pt, optscale,
+                                  parms_id);
+    }
+
+    /*
+    Encode `vec` replicated over all the slots. The replicas are written to a
+    buffer of the calling thread, reused by its next encodings, rather than to
+    a new full-size vector.
+    */
+    template <class CKKSEncoder>
+    void encode_replicated(const gsl::span<const double>& vec, Plaintext& pt,
+                           optional<double> optscale = {}) {
+        auto encoder = this->get<CKKSEncoder>();
+        size_t slot_count = encoder->slot_count();
+        if (vec.empty() || vec.size() > slot_count)
+            throw invalid_argument("can't replicate the vector over the slots");
+
+        thread_local vector<double> replicas;
+        replicas.resize(slot_count);
+        for (size_t i = 0; i < slot_count; i += vec.size())
+            std::copy_n(vec.begin(), std::min(vec.size(), slot_count - i),
+                        replicas.begin() + i);
+        encoder->encode(replicas, unwrap_scale(optscale), pt,
+                        sync::ThreadPool::memory_pool());
     }
 
     template <class CKKSEncoder>
     void encode(double value, Plaintext& pt, optional<double> optscale = {}) {
         auto encoder = this->get<CKKSEncoder>();
-        encoder->encode(value, unwrap_scale(optscale), pt);
+        encoder->encode(value, unwrap_scale(optscale), pt,
+                        sync::ThreadPool::memory_pool());
+    }
+    template <class CKKSEncoder>
+    void encode(double value, Plaintext& pt, optional<double> optscale,
+                const parms_id_type& parms_id) {
+        auto encoder = this->get<CKKSEncoder>();
+        encoder->encode(value, parms_id, unwrap_scale(optscale), pt,
+                        sync::ThreadPool::memory_pool());
     }
 
     /*
@@ -90,7 +167,7 @@ class TenSEALEncoder {
     template <class T, class R>
     void decode(const Plaintext& pt, R& result) {
         auto encoder = this->get<T>();
-        encoder->decode(pt, result);
+        encoder->decode(pt, result, sync::ThreadPool::memory_pool());
     }
 
     /*
@@ -117,6 +194,11 @@ class TenSEALEncoder {
         return this->_scale.value();
     }
 
+    /*
+    Returns the cache of the plaintexts encoded at a given parms_id.
+    */
+    shared_ptr<EncodeCache> encode_cache() { return this->_encode_cache; }
+
    private:
     // Can throw exception in case of invalid parameters
     template <typename T>
@@ -158,6 +240,10 @@ class TenSEALEncoder {
     */
     optional<double> _scale;
     /*
+    Stores the CKKS encodings of the plain operands, disabled by default.
+    */
+    shared_ptr<EncodeCache> _encode_cache = make_shared<EncodeCache>();
+    /*
     Read/write lock
     */
     std::shared_mutex mutex_;
@@ -5,9 +5,11 @@
 #include "tenseal/cpp/tensors/bfvvector.h"
 #include "tenseal/cpp/tensors/ckkstensor.h"
 #include "tenseal/cpp/tensors/ckksvector.h"
+#include "tenseal/cpp/tensors/encoded_matrix.h"
 #include "tenseal/cpp/tensors/encrypted_tensor.h"
 #include "tenseal/cpp/tensors/encrypted_vector.h"
 #include "tenseal/cpp/tensors/plain_tensor.h"
+#include "tenseal/cpp/tensors/utils/rotation_planner.h"
 #include "tenseal/cpp/tensors/utils/utils.h"
 
 #endif
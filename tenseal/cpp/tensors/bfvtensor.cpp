@@ -19,18 +19,29 @@ BFVTensor::BFVTensor(const shared_ptr<TenSEALContext>& ctx,
     this->prepare_context(ctx);
 
     vector<Ciphertext> enc_data;
+    vector<string> seeded;
     vector<size_t> enc_shape = tensor.shape();
     if (batch) {
         _batch_size = enc_shape[0];
         auto data = tensor.batch(0);
         enc_shape.erase(enc_shape.begin());
 
-        for (auto it = data.cbegin(); it != data.cend(); it++)
-            enc_data.push_back(BFVTensor::encrypt(ctx, *it));
+        for (auto it = data.cbegin(); it != data.cend(); it++) {
+            seeded.emplace_back();
+            enc_data.push_back(BFVTensor::encrypt(ctx, *it, &seeded.back()));
+        }
 
     } else {
-        for (auto it = tensor.cbegin(); it != tensor.cend(); it++)
-            enc_data.push_back(BFVTensor::encrypt(ctx, *it));
+        for (auto it = tensor.cbegin(); it != tensor.cend(); it++) {
+            seeded.emplace_back();
+            enc_data.push_back(BFVTensor::encrypt(ctx, *it, &seeded.back()));
+        }
+    }
+
+    if (ctx->enc_type() == encryption_type::symmetric) {
+        this->_seeded.resize(enc_data.size());
+        for (size_t i = 0; i < enc_data.size(); ++i)
+            this->keep_seeded(i, std::move(seeded[i]));
     }
 
     _data = TensorStorage<Ciphertext>(enc_data, enc_shape);
@@ -63,7 +74,7 @@ BFVTensor::BFVTensor(const shared_ptr<const BFVTensor>& tensor) {
 }
 
 Ciphertext BFVTensor::encrypt(const shared_ptr<TenSEALContext>& ctx,
-                              const vector<int64_t>& data) {
+                              const vector<int64_t>& data, string* seeded) {
     if (data.empty()) {
         throw invalid_argument("Attempting to encrypt an empty vector");
     }
@@ -74,74 +85,83 @@ Ciphertext BFVTensor::encrypt(const shared_ptr<TenSEALContext>& ctx,
             "can't encrypt vectors of this size, please use a larger "
             "polynomial modulus degree.");
 
-    Ciphertext ciphertext(*ctx->seal_context());
-    Plaintext plaintext;
+    Ciphertext ciphertext(*ctx->seal_context(), ctx->memory_pool());
+    Plaintext plaintext(ctx->memory_pool());
     ctx->encode<BatchEncoder>(data, plaintext);
-    ctx->encrypt(plaintext, ciphertext);
+    if (seeded)
+        *seeded = ctx->encrypt_seeded(plaintext, ciphertext);
+    else
+        ctx->encrypt(plaintext, ciphertext);
 
     return ciphertext;
 }
 
 Ciphertext BFVTensor::encrypt(const shared_ptr<TenSEALContext>& ctx,
-                              const int64_t data) {
-    Ciphertext ciphertext(*ctx->seal_context());
-    Plaintext plaintext;
+                              const int64_t data, string* seeded) {
+    Ciphertext ciphertext(*ctx->seal_context(), ctx->memory_pool());
+    Plaintext plaintext(ctx->memory_pool());
     ctx->encode<BatchEncoder>(data, plaintext);
-    ctx->encrypt(plaintext, ciphertext);
+    if (seeded)
+        *seeded = ctx->encrypt_seeded(plaintext, ciphertext);
+    else
+        ctx->encrypt(plaintext, ciphertext);
 
     return ciphertext;
 }
 
 PlainTensor<int64_t> BFVTensor::decrypt(const shared_ptr<SecretKey>& sk) const {
-    Plaintext plaintext;
     auto sz = this->_data.flat_size();
     auto shape = this->shape_with_batch();
+    auto decryptor = this->tenseal_context()->decryptor(sk);
+    auto ciphertexts = this->_data.data_ref();
 
-    if (_batch_size) {
-        vector<vector<int64_t>> result;
-        result.reserve(sz);
+    vector<vector<int64_t>> batched_result(_batch_size ? sz : 0);
+    vector<int64_t> result(_batch_size ? 0 : sz);
 
-        for (auto it = _data.cbegin(); it != _data.cend(); it++) {
-            vector<int64_t> buff;
-            this->tenseal_context()->decrypt(*sk, *it, plaintext);
+    // decrypt and decode on the dispatcher, every element of the result is
+    // written by a single worker
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
+        Plaintext plaintext;
+        vector<int64_t> buff;
+        for (size_t idx = start; idx < end; ++idx) {
+            decryptor->decrypt(ciphertexts[idx], plaintext);
             this->tenseal_context()->decode<BatchEncoder>(plaintext, buff);
-            result.push_back(
-                vector<int64_t>(buff.begin(), buff.begin() + *_batch_size));
+            if (_batch_size)
+                batched_result[idx].assign(buff.begin(),
+                                           buff.begin() + *_batch_size);
+            else
+                result[idx] = buff[0];
         }
+        return true;
+    };
+    this->dispatch_jobs(worker_func, sz);
 
-        return PlainTensor<int64_t>(/*batched_tensor=*/result,
+    if (_batch_size)
+        return PlainTensor<int64_t>(/*batched_tensor=*/batched_result,
                                     /*shape_with_batch=*/shape,
                                     /*batch_axis=*/0);
-    } else {
-        vector<int64_t> result;
-        result.reserve(sz);
-
-        for (auto it = _data.cbegin(); it != _data.cend(); it++) {
-            vector<int64_t> buff;
-            this->tenseal_context()->decrypt(*sk, *it, plaintext);
-            this->tenseal_context()->decode<BatchEncoder>(plaintext, buff);
-            result.push_back(buff[0]);
-        }
-
-        return PlainTensor<int64_t>(result, /*shape_with_batch=*/shape);
-    }
+    return PlainTensor<int64_t>(result, /*shape_with_batch=*/shape);
 }
 
 shared_ptr<BFVTensor> BFVTensor::negate_inplace() {
+    this->forget_seeded();
     for (auto& ct : _data)
         this->tenseal_context()->evaluator->negate_inplace(ct);
     return shared_from_this();
 }
 
 shared_ptr<BFVTensor> BFVTensor::square_inplace() {
+    this->forget_seeded();
     for (auto& ct : _data) {
-        this->tenseal_context()->evaluator->square_inplace(ct);
+        this->tenseal_context()->evaluator->square_inplace(
+            ct, this->tenseal_context()->memory_pool());
         this->auto_relin(ct);
     }
     return shared_from_this();
 }
 
 shared_ptr<BFVTensor> BFVTensor::power_inplace(unsigned int power) {
+    this->forget_seeded();
     if (power == 0) {
         auto ones = PlainTensor<int64_t>::repeat_value(1, this->shape());
         *this =
@@ -180,7 +200,8 @@ void BFVTensor::perform_op(seal::Ciphertext& ct, seal::Ciphertext other,
             this->tenseal_context()->evaluator->sub_inplace(ct, other);
             break;
         case OP::MUL:
-            this->tenseal_context()->evaluator->multiply_inplace(ct, other);
+            this->tenseal_context()->evaluator->multiply_inplace(
+                ct, other, this->tenseal_context()->memory_pool());
             this->auto_relin(ct);
             break;
         default:
@@ -192,15 +213,17 @@ void BFVTensor::perform_plain_op(seal::Ciphertext& ct, seal::Plaintext other,
                                  OP op) {
     switch (op) {
         case OP::ADD:
-            this->tenseal_context()->evaluator->add_plain_inplace(ct, other);
+            this->tenseal_context()->evaluator->add_plain_inplace(
+                ct, other, this->tenseal_context()->memory_pool());
             break;
         case OP::SUB:
-            this->tenseal_context()->evaluator->sub_plain_inplace(ct, other);
+            this->tenseal_context()->evaluator->sub_plain_inplace(
+                ct, other, this->tenseal_context()->memory_pool());
             break;
         case OP::MUL:
             try {
                 this->tenseal_context()->evaluator->multiply_plain_inplace(
-                    ct, other);
+                    ct, other, this->tenseal_context()->memory_pool());
             } catch (const std::logic_error& e) {
                 if (strcmp(e.what(), "result ciphertext is transparent") == 0) {
                     // replace by encryption of zero
@@ -218,6 +241,7 @@ void BFVTensor::perform_plain_op(seal::Ciphertext& ct, seal::Plaintext other,
 
 shared_ptr<BFVTensor> BFVTensor::op_inplace(
     const shared_ptr<BFVTensor>& raw_operand, OP op) {
+    this->forget_seeded();
     auto operand = raw_operand;
     if (this->shape() != operand->shape()) {
         operand = this->broadcast_or_throw(operand);
@@ -238,6 +262,7 @@ shared_ptr<BFVTensor> BFVTensor::op_inplace(
 
 shared_ptr<BFVTensor> BFVTensor::op_plain_inplace(
     const PlainTensor<int64_t>& raw_operand, OP op) {
+    this->forget_seeded();
     // TODO batched ops
 
     auto operand = raw_operand;
@@ -262,6 +287,7 @@ shared_ptr<BFVTensor> BFVTensor::op_plain_inplace(
 
 shared_ptr<BFVTensor> BFVTensor::op_plain_inplace(const int64_t& operand,
                                                   OP op) {
+    this->forget_seeded();
     Plaintext plaintext;
     this->tenseal_context()->encode<BatchEncoder>(operand, plaintext);
 
@@ -320,6 +346,7 @@ shared_ptr<BFVTensor> BFVTensor::mul_plain_inplace(const int64_t& to_mul) {
 }
 
 shared_ptr<BFVTensor> BFVTensor::sum_inplace(size_t axis) {
+    this->forget_seeded();
     if (axis >= shape_with_batch().size())
         throw invalid_argument("invalid axis");
 
@@ -352,20 +379,32 @@ shared_ptr<BFVTensor> BFVTensor::sum_inplace(size_t axis) {
         batches[new_idx].push_back(_data.flat_ref_at(idx));
     }
 
-    for (size_t idx = 0; idx < new_len; ++idx) {
-        tenseal_context()->evaluator->add_many(batches[idx], new_data[idx]);
-    }
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
+        for (size_t idx = start; idx < end; ++idx) {
+            tenseal_context()->evaluator->add_many(batches[idx],
+                                                   new_data[idx]);
+        }
+        return true;
+    };
+
+    this->dispatch_jobs(worker_func, new_len);
 
     _data = TensorStorage<Ciphertext>(new_data, new_shape);
     return shared_from_this();
 }
 shared_ptr<BFVTensor> BFVTensor::sum_batch_inplace() {
+    this->forget_seeded();
     if (!_batch_size) throw invalid_argument("unsupported operation");
 
-    for (size_t idx = 0; idx < _data.flat_size(); ++idx) {
-        sum_vector(this->tenseal_context(), _data.flat_ref_at(idx),
-                   *_batch_size);
-    }
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
+        for (size_t idx = start; idx < end; ++idx) {
+            sum_vector(this->tenseal_context(), _data.flat_ref_at(idx),
+                       *_batch_size);
+        }
+        return true;
+    };
+
+    this->dispatch_jobs(worker_func, _data.flat_size());
 
     _batch_size = {};
     return shared_from_this();
@@ -373,6 +412,7 @@ shared_ptr<BFVTensor> BFVTensor::sum_batch_inplace() {
 
 shared_ptr<BFVTensor> BFVTensor::polyval_inplace(
     const vector<int64_t>& coefficients) {
+    this->forget_seeded();
     if (coefficients.size() == 0) {
         throw invalid_argument(
             "the coefficients vector need to have at least one element");
@@ -424,6 +464,7 @@ shared_ptr<BFVTensor> BFVTensor::polyval_inplace(
 
 shared_ptr<BFVTensor> BFVTensor::dot_inplace(
     const shared_ptr<BFVTensor>& other) {
+    this->forget_seeded();
     auto this_shape = this->shape();
     auto other_shape = other->shape();
     if (this_shape.size() == 1) {
@@ -467,6 +508,7 @@ shared_ptr<BFVTensor> BFVTensor::dot_inplace(
 
 shared_ptr<BFVTensor> BFVTensor::dot_plain_inplace(
     const PlainTensor<int64_t>& other) {
+    this->forget_seeded();
     auto this_shape = this->shape();
     auto other_shape = other.shape();
     if (this_shape.size() == 1) {
@@ -510,6 +552,7 @@ shared_ptr<BFVTensor> BFVTensor::dot_plain_inplace(
 
 shared_ptr<BFVTensor> BFVTensor::matmul_inplace(
     const shared_ptr<BFVTensor>& other) {
+    this->forget_seeded();
     auto this_shape = this->shape();
     auto other_shape = other->shape();
 
@@ -538,10 +581,11 @@ shared_ptr<BFVTensor> BFVTensor::matmul_inplace(
                 this->perform_op(to_sum[j], other->_data.at({j, col}), OP::MUL);
             }
             Ciphertext acc(*this->tenseal_context()->seal_context(),
-                           to_sum[0].parms_id());
+                           to_sum[0].parms_id(),
+                           this->tenseal_context()->memory_pool());
             evaluator->add_many(to_sum, acc);
             // set element[row, col] to the computed inner product
-            new_data[i] = acc;
+            new_data[i] = std::move(acc);
         }
         return true;
     };
@@ -554,6 +598,7 @@ shared_ptr<BFVTensor> BFVTensor::matmul_inplace(
 
 shared_ptr<BFVTensor> BFVTensor::matmul_plain_inplace(
     const PlainTensor<int64_t>& other) {
+    this->forget_seeded();
     auto this_shape = this->shape();
     auto other_shape = other.shape();
 
@@ -585,10 +630,11 @@ shared_ptr<BFVTensor> BFVTensor::matmul_plain_inplace(
                 this->perform_plain_op(to_sum[j], pt, OP::MUL);
             }
             Ciphertext acc(*this->tenseal_context()->seal_context(),
-                           to_sum[0].parms_id());
+                           to_sum[0].parms_id(),
+                           this->tenseal_context()->memory_pool());
             evaluator->add_many(to_sum, acc);
             // set element[row, col] to the computed inner product
-            new_data[i] = acc;
+            new_data[i] = std::move(acc);
         }
         return true;
     };
@@ -600,6 +646,7 @@ shared_ptr<BFVTensor> BFVTensor::matmul_plain_inplace(
 }
 
 void BFVTensor::clear() {
+    this->forget_seeded();
     this->_data = TensorStorage<Ciphertext>();
     this->_batch_size = optional<int64_t>();
 }
@@ -610,17 +657,29 @@ void BFVTensor::load_proto(const BFVTensorProto& tensor_proto) {
     }
     this->clear();
 
-    vector<Ciphertext> enc_data;
     vector<size_t> enc_shape;
 
     for (int64_t idx = 0; idx < tensor_proto.shape_size(); ++idx) {
         enc_shape.push_back(tensor_proto.shape(idx));
     }
-    for (int64_t idx = 0; idx < tensor_proto.ciphertexts_size(); ++idx)
-        enc_data.push_back(SEALDeserialize<Ciphertext>(
-            *this->tenseal_context()->seal_context(),
-            tensor_proto.ciphertexts(idx)));
-    this->_data = TensorStorage<Ciphertext>(enc_data, enc_shape);
+    size_t size = tensor_proto.ciphertexts_size();
+    this->_data =
+        TensorStorage<Ciphertext>(vector<Ciphertext>(size), enc_shape);
+
+    // deserialize on the dispatcher, so the ciphertexts are allocated from
+    // the memory of the workers.
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
+        for (size_t idx = start; idx < end; ++idx) {
+            this->_data.flat_ref_at(idx) = SEALDeserialize<Ciphertext>(
+                *this->tenseal_context()->seal_context(),
+                tensor_proto.ciphertexts(static_cast<int>(idx)),
+                this->tenseal_context()->memory_pool());
+        }
+        return true;
+    };
+
+    this->dispatch_jobs(worker_func, size);
+
     if (tensor_proto.batch_size())
         this->_batch_size = tensor_proto.batch_size();
 }
@@ -628,8 +687,9 @@ void BFVTensor::load_proto(const BFVTensorProto& tensor_proto) {
 BFVTensorProto BFVTensor::save_proto() const {
     BFVTensorProto buffer;
 
+    size_t idx = 0;
     for (auto& ct : this->data()) {
-        buffer.add_ciphertexts(SEALSerialize<Ciphertext>(ct));
+        buffer.add_ciphertexts(this->serialize_ciphertext(idx++, ct));
     }
     for (auto& dim : this->shape()) {
         buffer.add_shape(dim);
@@ -678,11 +738,10 @@ shared_ptr<BFVTensor> BFVTensor::copy() const {
 shared_ptr<BFVTensor> BFVTensor::deepcopy() const {
     if (_lazy_buffer) return this->copy();
 
-    TenSEALContextProto ctx = this->tenseal_context()->save_proto(
-        /*save_public_key=*/true, /*save_secret_key=*/true,
-        /*save_galois_keys=*/true, /*save_relin_keys=*/true);
-    BFVTensorProto vec = this->save_proto();
-    return BFVTensor::Create(ctx, vec);
+    // the ciphertexts are copied, the context shares its keys with the copy
+    auto result = this->copy();
+    result->link_tenseal_context(this->tenseal_context()->copy());
+    return result;
 }
 
 vector<Ciphertext> BFVTensor::data() const { return _data.data(); }
@@ -713,6 +772,7 @@ shared_ptr<BFVTensor> BFVTensor::broadcast(
 }
 shared_ptr<BFVTensor> BFVTensor::broadcast_inplace(
     const vector<size_t>& other_shape) {
+    this->forget_seeded();
     this->_data.broadcast_inplace(other_shape);
 
     return shared_from_this();
@@ -722,6 +782,7 @@ shared_ptr<BFVTensor> BFVTensor::transpose() const {
     return this->copy()->transpose_inplace();
 }
 shared_ptr<BFVTensor> BFVTensor::transpose_inplace() {
+    this->forget_seeded();
     this->_data.transpose_inplace();
 
     return shared_from_this();
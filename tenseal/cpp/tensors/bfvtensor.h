@@ -129,10 +129,15 @@ class BFVTensor : public EncryptedTensor<int64_t, shared_ptr<BFVTensor>>,
               const BFVTensorProto& tensor);
     BFVTensor(const shared_ptr<const BFVTensor>& vec);
 
+    /**
+     * Encrypt a batch or a single value, "seeded" receives the seeded
+     *serialization of the ciphertext for the symmetric contexts.
+     **/
     static Ciphertext encrypt(const shared_ptr<TenSEALContext>& ctx,
-                              const vector<int64_t>& data);
+                              const vector<int64_t>& data,
+                              string* seeded = nullptr);
     static Ciphertext encrypt(const shared_ptr<TenSEALContext>& ctx,
-                              const int64_t data);
+                              const int64_t data, string* seeded = nullptr);
 
     enum class OP { ADD, SUB, MUL };
     void perform_op(seal::Ciphertext& ct, seal::Ciphertext other, OP op);
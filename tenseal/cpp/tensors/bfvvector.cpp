@@ -33,9 +33,12 @@ BFVVector::BFVVector(const shared_ptr<TenSEALContext>& ctx,
     }
     this->_ciphertexts = vector<Ciphertext>();
     this->_sizes = vector<size_t>();
+    this->_seeded.resize(vec_chunks.size());
 
     for (auto& chunk : vec_chunks) {
-        this->_ciphertexts.push_back(BFVVector::encrypt(ctx, chunk));
+        string seeded;
+        this->_ciphertexts.push_back(BFVVector::encrypt(ctx, chunk, &seeded));
+        this->keep_seeded(this->_ciphertexts.size() - 1, std::move(seeded));
         this->_sizes.push_back(chunk.size());
     }
 }
@@ -65,7 +68,7 @@ BFVVector::BFVVector(const shared_ptr<const BFVVector>& vec) {
 }
 
 Ciphertext BFVVector::encrypt(shared_ptr<TenSEALContext> context,
-                              BFVVector::plain_t pt) {
+                              BFVVector::plain_t pt, string* seeded) {
     if (pt.empty()) {
         throw invalid_argument("Attempting to encrypt an empty vector");
     }
@@ -80,36 +83,44 @@ Ciphertext BFVVector::encrypt(shared_ptr<TenSEALContext> context,
     Plaintext plaintext;
     pt.replicate(slot_count);
     context->encode<BatchEncoder>(pt.data(), plaintext);
-    context->encrypt(plaintext, ciphertext);
+    if (seeded)
+        *seeded = context->encrypt_seeded(plaintext, ciphertext);
+    else
+        context->encrypt(plaintext, ciphertext);
 
     return ciphertext;
 }
 
 BFVVector::plain_t BFVVector::decrypt(const shared_ptr<SecretKey>& sk) const {
-    vector<int64_t> result;
-    result.reserve(this->size());
-
-    for (size_t idx = 0; idx < this->_ciphertexts.size(); ++idx) {
-        vector<int64_t> partial_result;
+    auto decryptor = this->tenseal_context()->decryptor(sk);
+    vector<vector<int64_t>> partial_results(this->_ciphertexts.size());
 
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
         Plaintext plaintext;
-        this->tenseal_context()->decrypt(*sk, this->_ciphertexts[idx],
-                                         plaintext);
-        this->tenseal_context()->decode<BatchEncoder>(plaintext,
-                                                      partial_result);
+        for (size_t idx = start; idx < end; ++idx) {
+            decryptor->decrypt(this->_ciphertexts[idx], plaintext);
+            this->tenseal_context()->decode<BatchEncoder>(plaintext,
+                                                          partial_results[idx]);
+        }
+        return true;
+    };
+    this->dispatch_jobs(worker_func, this->_ciphertexts.size());
 
+    vector<int64_t> result;
+    result.reserve(this->size());
+    for (size_t idx = 0; idx < partial_results.size(); ++idx) {
         // result contains all slots of ciphertext (poly_modulus_degree)
         // we use the real vector size to delimit the resulting plaintext vector
-        auto partial_decr =
-            vector<int64_t>(partial_result.cbegin(),
-                            partial_result.cbegin() + this->_sizes[idx]);
-        result.insert(result.end(), partial_decr.begin(), partial_decr.end());
+        auto& partial_result = partial_results[idx];
+        result.insert(result.end(), partial_result.cbegin(),
+                      partial_result.cbegin() + this->_sizes[idx]);
     }
 
     return result;
 }
 
 shared_ptr<BFVVector> BFVVector::power_inplace(unsigned int power) {
+    this->forget_seeded();
     // if the power is zero, return a new encrypted vector of ones
     if (power == 0) {
         vector<int64_t> ones(this->size(), 1);
@@ -139,6 +150,7 @@ shared_ptr<BFVVector> BFVVector::power_inplace(unsigned int power) {
 }
 
 shared_ptr<BFVVector> BFVVector::negate_inplace() {
+    this->forget_seeded();
     for (auto& ct : this->_ciphertexts)
         this->tenseal_context()->evaluator->negate_inplace(ct);
 
@@ -146,8 +158,10 @@ shared_ptr<BFVVector> BFVVector::negate_inplace() {
 }
 
 shared_ptr<BFVVector> BFVVector::square_inplace() {
+    this->forget_seeded();
     for (auto& ct : this->_ciphertexts) {
-        this->tenseal_context()->evaluator->square_inplace(ct);
+        this->tenseal_context()->evaluator->square_inplace(
+            ct, this->tenseal_context()->memory_pool());
         this->auto_relin(ct);
     }
 
@@ -156,6 +170,7 @@ shared_ptr<BFVVector> BFVVector::square_inplace() {
 
 shared_ptr<BFVVector> BFVVector::add_inplace(
     const shared_ptr<BFVVector>& other) {
+    this->forget_seeded();
     auto to_add = other->copy();
     if (!this->tenseal_context()->equals(to_add->tenseal_context())) {
         // Different contexts means different parameters
@@ -174,6 +189,7 @@ shared_ptr<BFVVector> BFVVector::add_inplace(
 
 shared_ptr<BFVVector> BFVVector::sub_inplace(
     const shared_ptr<BFVVector>& other) {
+    this->forget_seeded();
     auto to_sub = other->copy();
     if (!this->tenseal_context()->equals(to_sub->tenseal_context())) {
         // Different contexts means different parameters
@@ -192,6 +208,7 @@ shared_ptr<BFVVector> BFVVector::sub_inplace(
 
 shared_ptr<BFVVector> BFVVector::mul_inplace(
     const shared_ptr<BFVVector>& other) {
+    this->forget_seeded();
     auto to_mul = other->copy();
     if (!this->tenseal_context()->equals(to_mul->tenseal_context())) {
         // Different contexts means different parameters
@@ -203,7 +220,8 @@ shared_ptr<BFVVector> BFVVector::mul_inplace(
 
     for (size_t idx = 0; idx < this->_ciphertexts.size(); ++idx) {
         this->tenseal_context()->evaluator->multiply_inplace(
-            this->_ciphertexts[idx], to_mul->_ciphertexts[idx]);
+            this->_ciphertexts[idx], to_mul->_ciphertexts[idx],
+            this->tenseal_context()->memory_pool());
         this->auto_relin(_ciphertexts[idx]);
     }
 
@@ -227,6 +245,7 @@ shared_ptr<BFVVector> BFVVector::dot_plain_inplace(
 }
 
 shared_ptr<BFVVector> BFVVector::sum_inplace(size_t /*axis=0*/) {
+    this->forget_seeded();
     vector<Ciphertext> interm_sum;
     size_t size = this->_ciphertexts.size();
     interm_sum.resize(size);
@@ -252,12 +271,14 @@ shared_ptr<BFVVector> BFVVector::sum_inplace(size_t /*axis=0*/) {
 
 shared_ptr<BFVVector> BFVVector::add_plain_inplace(
     const plain_t::dtype& to_add) {
+    this->forget_seeded();
     for (auto& ct : this->_ciphertexts) this->_add_plain_inplace(ct, to_add);
     return shared_from_this();
 }
 
 shared_ptr<BFVVector> BFVVector::add_plain_inplace(
     const BFVVector::plain_t& vector_to_add) {
+    this->forget_seeded();
     if (this->size() != vector_to_add.size()) {
         throw invalid_argument("can't add vectors of different sizes");
     }
@@ -276,7 +297,8 @@ template <typename T>
 void BFVVector::_add_plain_inplace(Ciphertext& ct, const T& to_add) {
     Plaintext plaintext;
     this->tenseal_context()->encode<BatchEncoder>(to_add, plaintext);
-    this->tenseal_context()->evaluator->add_plain_inplace(ct, plaintext);
+    this->tenseal_context()->evaluator->add_plain_inplace(
+        ct, plaintext, this->tenseal_context()->memory_pool());
 }
 
 shared_ptr<BFVVector> BFVVector::sub_plain_inplace(
@@ -286,6 +308,7 @@ shared_ptr<BFVVector> BFVVector::sub_plain_inplace(
 
 shared_ptr<BFVVector> BFVVector::sub_plain_inplace(
     const BFVVector::plain_t& vector_to_sub) {
+    this->forget_seeded();
     if (this->size() != vector_to_sub.size()) {
         throw invalid_argument("can't sub vectors of different sizes");
     }
@@ -299,7 +322,8 @@ shared_ptr<BFVVector> BFVVector::sub_plain_inplace(
         this->tenseal_context()->encode<BatchEncoder>(to_sub[idx].data_ref(),
                                                       plaintext);
         this->tenseal_context()->evaluator->sub_plain_inplace(
-            this->_ciphertexts[idx], plaintext);
+            this->_ciphertexts[idx], plaintext,
+            this->tenseal_context()->memory_pool());
     }
     return shared_from_this();
 }
@@ -308,11 +332,13 @@ template <typename T>
 void BFVVector::_mul_plain_inplace(Ciphertext& ct, const T& to_mul) {
     Plaintext plaintext;
     this->tenseal_context()->encode<BatchEncoder>(to_mul, plaintext);
-    this->tenseal_context()->evaluator->multiply_plain_inplace(ct, plaintext);
+    this->tenseal_context()->evaluator->multiply_plain_inplace(
+        ct, plaintext, this->tenseal_context()->memory_pool());
 }
 
 shared_ptr<BFVVector> BFVVector::mul_plain_inplace(
     const plain_t::dtype& to_mul) {
+    this->forget_seeded();
     for (auto& ct : this->_ciphertexts) this->_mul_plain_inplace(ct, to_mul);
 
     return shared_from_this();
@@ -320,6 +346,7 @@ shared_ptr<BFVVector> BFVVector::mul_plain_inplace(
 
 shared_ptr<BFVVector> BFVVector::mul_plain_inplace(
     const BFVVector::plain_t& vector_to_mul) {
+    this->forget_seeded();
     if (this->size() != vector_to_mul.size()) {
         throw invalid_argument("can't multiply vectors of different sizes");
     }
@@ -352,6 +379,7 @@ shared_ptr<BFVVector> BFVVector::matmul_plain_inplace(
 
 shared_ptr<BFVVector> BFVVector::polyval_inplace(
     const vector<int64_t>& coefficients) {
+    this->forget_seeded();
     if (coefficients.size() == 0) {
         throw invalid_argument(
             "the coefficients vector need to have at least one element");
@@ -415,6 +443,7 @@ shared_ptr<BFVVector> BFVVector::enc_matmul_plain_inplace(
 }
 
 shared_ptr<BFVVector> BFVVector::replicate_first_slot_inplace(size_t n) {
+    this->forget_seeded();
     if (this->_ciphertexts.size() != 1)
         throw invalid_argument(
             "can't execute replicate_first_slot on chunked vectors");
@@ -426,10 +455,12 @@ shared_ptr<BFVVector> BFVVector::replicate_first_slot_inplace(size_t n) {
 
     // replicate
     Ciphertext tmp = this->_ciphertexts[0];
-    auto galois_keys = this->tenseal_context()->galois_keys();
-    for (size_t i = 0; i < (size_t)ceil(log2(n)); i++) {
+    auto steps = replicate_steps(n);
+    auto galois_keys = this->tenseal_context()->galois_keys(steps);
+    for (int step : steps) {
         this->tenseal_context()->evaluator->rotate_vector_inplace(
-            tmp, static_cast<int>(-pow(2, i)), *galois_keys);
+            tmp, step, *galois_keys,
+            this->tenseal_context()->memory_pool());
         this->tenseal_context()->evaluator->add_inplace(this->_ciphertexts[0],
                                                         tmp);
         tmp = this->_ciphertexts[0];
@@ -444,19 +475,33 @@ void BFVVector::load_proto(const BFVVectorProto& vec) {
         throw invalid_argument("context missing for deserialization");
     }
     this->_sizes = vector<size_t>();
+    this->forget_seeded();
     this->_ciphertexts = vector<Ciphertext>();
 
     for (auto& sz : vec.sizes()) this->_sizes.push_back(sz);
-    for (auto& ct : vec.ciphertexts())
-        this->_ciphertexts.push_back(SEALDeserialize<Ciphertext>(
-            *this->tenseal_context()->seal_context(), ct));
+    this->_ciphertexts.resize(vec.ciphertexts_size());
+
+    // deserialize on the dispatcher, so the ciphertexts are allocated from
+    // the memory of the workers.
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
+        for (size_t idx = start; idx < end; ++idx) {
+            this->_ciphertexts[idx] = SEALDeserialize<Ciphertext>(
+                *this->tenseal_context()->seal_context(),
+                vec.ciphertexts(static_cast<int>(idx)),
+                this->tenseal_context()->memory_pool());
+        }
+        return true;
+    };
+
+    this->dispatch_jobs(worker_func, this->_ciphertexts.size());
 }
 
 BFVVectorProto BFVVector::save_proto() const {
     BFVVectorProto buffer;
 
-    for (auto& ct : this->_ciphertexts) {
-        buffer.add_ciphertexts(SEALSerialize<Ciphertext>(ct));
+    for (size_t idx = 0; idx < this->_ciphertexts.size(); ++idx) {
+        buffer.add_ciphertexts(
+            this->serialize_ciphertext(idx, this->_ciphertexts[idx]));
     }
     for (auto& sz : this->_sizes) {
         buffer.add_sizes(sz);
@@ -501,10 +546,9 @@ shared_ptr<BFVVector> BFVVector::copy() const {
 shared_ptr<BFVVector> BFVVector::deepcopy() const {
     if (_lazy_buffer) return this->copy();
 
-    TenSEALContextProto ctx = this->tenseal_context()->save_proto(
-        /*save_public_key=*/true, /*save_secret_key=*/true,
-        /*save_galois_keys=*/true, /*save_relin_keys=*/true);
-    BFVVectorProto vec = this->save_proto();
-    return BFVVector::Create(ctx, vec);
+    // the ciphertexts are copied, the context shares its keys with the copy
+    auto result = this->copy();
+    result->link_tenseal_context(this->tenseal_context()->copy());
+    return result;
 }
 }  // namespace tenseal
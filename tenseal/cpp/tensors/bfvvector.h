@@ -138,8 +138,12 @@ class BFVVector
     BFVVector(const TenSEALContextProto& ctx, const BFVVectorProto& vec);
     BFVVector(const shared_ptr<TenSEALContext>& ctx, const BFVVectorProto& vec);
 
+    /**
+     * Encrypt a chunk, "seeded" receives the seeded serialization of the
+     *ciphertext for the symmetric contexts.
+     **/
     static Ciphertext encrypt(shared_ptr<TenSEALContext> context,
-                              plain_t input);
+                              plain_t input, string* seeded = nullptr);
 
     void load_proto(const BFVVectorProto& buffer);
     BFVVectorProto save_proto() const;
@@ -15,7 +15,6 @@ CKKSTensor::CKKSTensor(const shared_ptr<TenSEALContext>& ctx,
         this->_init_scale = ctx->global_scale();
     }
 
-    vector<Ciphertext> enc_data;
     vector<size_t> enc_shape = tensor.shape();
     auto data = tensor.batch(0);
     size_t size;
@@ -26,27 +25,28 @@ CKKSTensor::CKKSTensor(const shared_ptr<TenSEALContext>& ctx,
     } else {
         size = tensor.flat_size();
     }
-    enc_data.resize(size);
+    // the ciphertexts are encrypted in place, so they keep the memory of the
+    // worker which encrypted them.
+    _data = TensorStorage<Ciphertext>(vector<Ciphertext>(size), enc_shape);
+    if (ctx->enc_type() == encryption_type::symmetric)
+        this->_seeded.resize(size);
 
     task_t worker_func = [&](size_t start, size_t end) -> bool {
-        if (batch) {
-            for (size_t i = start; i < end; i++) {
-                enc_data[i] =
-                    CKKSTensor::encrypt(ctx, this->_init_scale, data.at(i));
-            }
-        } else {
-            for (size_t i = start; i < end; i++) {
-                enc_data[i] = CKKSTensor::encrypt(ctx, this->_init_scale,
-                                                  tensor.flat_at(i));
-            }
+        for (size_t i = start; i < end; i++) {
+            string seeded;
+            if (batch)
+                _data.flat_ref_at(i) = CKKSTensor::encrypt(
+                    ctx, this->_init_scale, data.at(i), &seeded);
+            else
+                _data.flat_ref_at(i) = CKKSTensor::encrypt(
+                    ctx, this->_init_scale, tensor.flat_at(i), &seeded);
+            this->keep_seeded(i, std::move(seeded));
         }
 
         return true;
     };
 
     this->dispatch_jobs(worker_func, size);
-
-    _data = TensorStorage<Ciphertext>(enc_data, enc_shape);
 }
 
 CKKSTensor::CKKSTensor(const shared_ptr<TenSEALContext>& ctx,
@@ -85,7 +85,8 @@ CKKSTensor::CKKSTensor(const shared_ptr<const CKKSTensor>& tensor,
 }
 
 Ciphertext CKKSTensor::encrypt(const shared_ptr<TenSEALContext>& ctx,
-                               const double scale, const vector<double>& data) {
+                               const double scale, const vector<double>& data,
+                               string* seeded) {
     if (data.empty()) {
         throw invalid_argument("Attempting to encrypt an empty vector");
     }
@@ -96,68 +97,77 @@ Ciphertext CKKSTensor::encrypt(const shared_ptr<TenSEALContext>& ctx,
             "can't encrypt vectors of this size, please use a larger "
             "polynomial modulus degree.");
 
-    Ciphertext ciphertext(*ctx->seal_context());
-    Plaintext plaintext;
+    Ciphertext ciphertext(*ctx->seal_context(), ctx->memory_pool());
+    Plaintext plaintext(ctx->memory_pool());
     ctx->encode<CKKSEncoder>(data, plaintext, scale);
-    ctx->encrypt(plaintext, ciphertext);
+    if (seeded)
+        *seeded = ctx->encrypt_seeded(plaintext, ciphertext);
+    else
+        ctx->encrypt(plaintext, ciphertext);
 
     return ciphertext;
 }
 
 Ciphertext CKKSTensor::encrypt(const shared_ptr<TenSEALContext>& ctx,
-                               const double scale, const double data) {
-    Ciphertext ciphertext(*ctx->seal_context());
-    Plaintext plaintext;
+                               const double scale, const double data,
+                               string* seeded) {
+    Ciphertext ciphertext(*ctx->seal_context(), ctx->memory_pool());
+    Plaintext plaintext(ctx->memory_pool());
     ctx->encode<CKKSEncoder>(data, plaintext, scale);
-    ctx->encrypt(plaintext, ciphertext);
+    if (seeded)
+        *seeded = ctx->encrypt_seeded(plaintext, ciphertext);
+    else
+        ctx->encrypt(plaintext, ciphertext);
 
     return ciphertext;
 }
 
 PlainTensor<double> CKKSTensor::decrypt(const shared_ptr<SecretKey>& sk) const {
-    Plaintext plaintext;
     auto sz = this->_data.flat_size();
     auto shape = this->shape_with_batch();
+    auto decryptor = this->tenseal_context()->decryptor(sk);
+    auto ciphertexts = this->_data.data_ref();
 
-    if (_batch_size) {
-        vector<vector<double>> result;
-        result.reserve(sz);
+    vector<vector<double>> batched_result(_batch_size ? sz : 0);
+    vector<double> result(_batch_size ? 0 : sz);
 
-        for (auto it = _data.cbegin(); it != _data.cend(); it++) {
-            vector<double> buff;
-            this->tenseal_context()->decrypt(*sk, *it, plaintext);
+    // decrypt and decode on the dispatcher, every element of the result is
+    // written by a single worker
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
+        Plaintext plaintext;
+        vector<double> buff;
+        for (size_t idx = start; idx < end; ++idx) {
+            decryptor->decrypt(ciphertexts[idx], plaintext);
             this->tenseal_context()->decode<CKKSEncoder>(plaintext, buff);
-            result.push_back(
-                vector<double>(buff.begin(), buff.begin() + *_batch_size));
+            if (_batch_size)
+                batched_result[idx].assign(buff.begin(),
+                                           buff.begin() + *_batch_size);
+            else
+                result[idx] = buff[0];
         }
+        return true;
+    };
+    this->dispatch_jobs(worker_func, sz);
 
-        return PlainTensor<double>(/*batched_tensor=*/result,
+    if (_batch_size)
+        return PlainTensor<double>(/*batched_tensor=*/batched_result,
                                    /*shape_with_batch=*/shape,
                                    /*batch_axis=*/0);
-    } else {
-        vector<double> result;
-        result.reserve(sz);
-
-        for (auto it = _data.cbegin(); it != _data.cend(); it++) {
-            vector<double> buff;
-            this->tenseal_context()->decrypt(*sk, *it, plaintext);
-            this->tenseal_context()->decode<CKKSEncoder>(plaintext, buff);
-            result.push_back(buff[0]);
-        }
-
-        return PlainTensor<double>(result, /*shape_with_batch=*/shape);
-    }
+    return PlainTensor<double>(result, /*shape_with_batch=*/shape);
 }
 
 shared_ptr<CKKSTensor> CKKSTensor::negate_inplace() {
+    this->forget_seeded();
     for (auto& ct : _data)
         this->tenseal_context()->evaluator->negate_inplace(ct);
     return shared_from_this();
 }
 
 shared_ptr<CKKSTensor> CKKSTensor::square_inplace() {
+    this->forget_seeded();
     for (auto& ct : _data) {
-        this->tenseal_context()->evaluator->square_inplace(ct);
+        this->tenseal_context()->evaluator->square_inplace(
+            ct, this->tenseal_context()->memory_pool());
         this->auto_relin(ct);
         this->auto_rescale(ct);
     }
@@ -165,6 +175,7 @@ shared_ptr<CKKSTensor> CKKSTensor::square_inplace() {
 }
 
 shared_ptr<CKKSTensor> CKKSTensor::power_inplace(unsigned int power) {
+    this->forget_seeded();
     if (power == 0) {
         auto ones = PlainTensor<double>::repeat_value(1, this->shape());
         *this = CKKSTensor(this->tenseal_context(), ones, this->_init_scale,
@@ -236,7 +247,8 @@ void CKKSTensor::perform_op(seal::Ciphertext& ct, seal::Ciphertext other,
             this->tenseal_context()->evaluator->sub_inplace(ct, other);
             break;
         case OP::MUL:
-            this->tenseal_context()->evaluator->multiply_inplace(ct, other);
+            this->tenseal_context()->evaluator->multiply_inplace(
+                ct, other, this->tenseal_context()->memory_pool());
             print_ciphertext_raw(ct, *this->tenseal_context()->seal_context(), "multiply_inplace");
             this->auto_relin(ct);
             print_ciphertext_raw(ct, *this->tenseal_context()->seal_context(), "relin");
@@ -253,15 +265,17 @@ void CKKSTensor::perform_plain_op(seal::Ciphertext& ct, seal::Plaintext other,
     this->auto_same_mod(other, ct);
     switch (op) {
         case OP::ADD:
-            this->tenseal_context()->evaluator->add_plain_inplace(ct, other);
+            this->tenseal_context()->evaluator->add_plain_inplace(
+                ct, other, this->tenseal_context()->memory_pool());
             break;
         case OP::SUB:
-            this->tenseal_context()->evaluator->sub_plain_inplace(ct, other);
+            this->tenseal_context()->evaluator->sub_plain_inplace(
+                ct, other, this->tenseal_context()->memory_pool());
             break;
         case OP::MUL:
             try {
                 this->tenseal_context()->evaluator->multiply_plain_inplace(
-                    ct, other);
+                    ct, other, this->tenseal_context()->memory_pool());
             } catch (const std::logic_error& e) {
                 if (strcmp(e.what(), "result ciphertext is transparent") == 0) {
                     // replace by encryption of zero
@@ -281,6 +295,7 @@ void CKKSTensor::perform_plain_op(seal::Ciphertext& ct, seal::Plaintext other,
 
 shared_ptr<CKKSTensor> CKKSTensor::op_inplace(
     const shared_ptr<CKKSTensor>& raw_operand, OP op) {
+    this->forget_seeded();
     auto operand = raw_operand;
     if (this->shape() != operand->shape()) {
         operand = this->broadcast_or_throw(operand);
@@ -301,6 +316,7 @@ shared_ptr<CKKSTensor> CKKSTensor::op_inplace(
 
 shared_ptr<CKKSTensor> CKKSTensor::op_plain_inplace(
     const PlainTensor<double>& raw_operand, OP op) {
+    this->forget_seeded();
     // TODO batched ops
 
     auto operand = raw_operand;
@@ -311,9 +327,11 @@ shared_ptr<CKKSTensor> CKKSTensor::op_plain_inplace(
     task_t worker_func = [&](size_t start, size_t end) -> bool {
         Plaintext plaintext;
         for (size_t i = start; i < end; i++) {
+            auto& ct = this->_data.flat_ref_at(i);
             this->tenseal_context()->encode<CKKSEncoder>(
-                operand.flat_at(i), plaintext, this->_init_scale);
-            this->perform_plain_op(this->_data.flat_ref_at(i), plaintext, op);
+                operand.flat_at(i), plaintext, this->_init_scale,
+                this->plain_parms_id(ct));
+            this->perform_plain_op(ct, plaintext, op);
         }
         return true;
     };
@@ -325,9 +343,13 @@ shared_ptr<CKKSTensor> CKKSTensor::op_plain_inplace(
 
 shared_ptr<CKKSTensor> CKKSTensor::op_plain_inplace(const double& operand,
                                                     OP op) {
+    this->forget_seeded();
+    // the ciphertexts of a tensor are usually at the same level, the others
+    // are switched by perform_plain_op
     Plaintext plaintext;
-    this->tenseal_context()->encode<CKKSEncoder>(operand, plaintext,
-                                                 this->_init_scale);
+    this->tenseal_context()->encode<CKKSEncoder>(
+        operand, plaintext, this->_init_scale,
+        this->plain_parms_id(this->_data.flat_ref_at(0)));
 
     task_t worker_func = [&](size_t start, size_t end) -> bool {
         for (size_t i = start; i < end; i++) {
@@ -384,6 +406,7 @@ shared_ptr<CKKSTensor> CKKSTensor::mul_plain_inplace(const double& to_mul) {
 }
 
 shared_ptr<CKKSTensor> CKKSTensor::sum_inplace(size_t axis) {
+    this->forget_seeded();
     if (axis >= shape_with_batch().size())
         throw invalid_argument("invalid axis");
 
@@ -416,20 +439,32 @@ shared_ptr<CKKSTensor> CKKSTensor::sum_inplace(size_t axis) {
         batches[new_idx].push_back(_data.flat_ref_at(idx));
     }
 
-    for (size_t idx = 0; idx < new_len; ++idx) {
-        tenseal_context()->evaluator->add_many(batches[idx], new_data[idx]);
-    }
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
+        for (size_t idx = start; idx < end; ++idx) {
+            tenseal_context()->evaluator->add_many(batches[idx],
+                                                   new_data[idx]);
+        }
+        return true;
+    };
+
+    this->dispatch_jobs(worker_func, new_len);
 
     _data = TensorStorage<Ciphertext>(new_data, new_shape);
     return shared_from_this();
 }
 shared_ptr<CKKSTensor> CKKSTensor::sum_batch_inplace() {
+    this->forget_seeded();
     if (!_batch_size) throw invalid_argument("unsupported operation");
 
-    for (size_t idx = 0; idx < _data.flat_size(); ++idx) {
-        sum_vector(this->tenseal_context(), _data.flat_ref_at(idx),
-                   *_batch_size);
-    }
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
+        for (size_t idx = start; idx < end; ++idx) {
+            sum_vector(this->tenseal_context(), _data.flat_ref_at(idx),
+                       *_batch_size);
+        }
+        return true;
+    };
+
+    this->dispatch_jobs(worker_func, _data.flat_size());
 
     _batch_size = {};
     return shared_from_this();
@@ -437,6 +472,7 @@ shared_ptr<CKKSTensor> CKKSTensor::sum_batch_inplace() {
 
 shared_ptr<CKKSTensor> CKKSTensor::polyval_inplace(
     const vector<double>& coefficients) {
+    this->forget_seeded();
     if (coefficients.size() == 0) {
         throw invalid_argument(
             "the coefficients vector need to have at least one element");
@@ -478,6 +514,7 @@ shared_ptr<CKKSTensor> CKKSTensor::polyval_inplace(
 
     // coefficients[1] * x + ... + coefficients[degree] * x^(degree)
     for (int i = 1; i <= degree; i++) {
+        sync::check_cancellation();
         if (coefficients[i] == 0.0) continue;
         x = compute_polynomial_term(i, coefficients[i], x_squares);
         result->add_inplace(x);
@@ -489,6 +526,7 @@ shared_ptr<CKKSTensor> CKKSTensor::polyval_inplace(
 
 shared_ptr<CKKSTensor> CKKSTensor::dot_inplace(
     const shared_ptr<CKKSTensor>& other) {
+    this->forget_seeded();
     auto this_shape = this->shape();
     auto other_shape = other->shape();
     if (this_shape.size() == 1) {
@@ -532,6 +570,7 @@ shared_ptr<CKKSTensor> CKKSTensor::dot_inplace(
 
 shared_ptr<CKKSTensor> CKKSTensor::dot_plain_inplace(
     const PlainTensor<double>& other) {
+    this->forget_seeded();
     auto this_shape = this->shape();
     auto other_shape = other.shape();
     if (this_shape.size() == 1) {
@@ -575,6 +614,7 @@ shared_ptr<CKKSTensor> CKKSTensor::dot_plain_inplace(
 
 shared_ptr<CKKSTensor> CKKSTensor::matmul_inplace(
     const shared_ptr<CKKSTensor>& other) {
+    this->forget_seeded();
     auto this_shape = this->shape();
     auto other_shape = other->shape();
 
@@ -603,10 +643,11 @@ shared_ptr<CKKSTensor> CKKSTensor::matmul_inplace(
                 this->perform_op(to_sum[j], other->_data.at({j, col}), OP::MUL);
             }
             Ciphertext acc(*this->tenseal_context()->seal_context(),
-                           to_sum[0].parms_id());
+                           to_sum[0].parms_id(),
+                           this->tenseal_context()->memory_pool());
             evaluator->add_many(to_sum, acc);
             // set element[row, col] to the computed inner product
-            new_data[i] = acc;
+            new_data[i] = std::move(acc);
         }
         return true;
     };
@@ -619,6 +660,7 @@ shared_ptr<CKKSTensor> CKKSTensor::matmul_inplace(
 
 shared_ptr<CKKSTensor> CKKSTensor::matmul_plain_inplace(
     const PlainTensor<double>& other) {
+    this->forget_seeded();
     auto this_shape = this->shape();
     auto other_shape = other.shape();
 
@@ -646,14 +688,16 @@ shared_ptr<CKKSTensor> CKKSTensor::matmul_plain_inplace(
                 to_sum[j] = this->_data.at({row, j});
                 Plaintext pt;
                 this->tenseal_context()->encode<CKKSEncoder>(
-                    other.at({j, col}), pt, this->_init_scale);
+                    other.at({j, col}), pt, this->_init_scale,
+                    this->plain_parms_id(to_sum[j]));
                 this->perform_plain_op(to_sum[j], pt, OP::MUL);
             }
             Ciphertext acc(*this->tenseal_context()->seal_context(),
-                           to_sum[0].parms_id());
+                           to_sum[0].parms_id(),
+                           this->tenseal_context()->memory_pool());
             evaluator->add_many(to_sum, acc);
             // set element[row, col] to the computed inner product
-            new_data[i] = acc;
+            new_data[i] = std::move(acc);
         }
         return true;
     };
@@ -671,6 +715,7 @@ CKKSTensor CKKSTensor::subscript(const vector<pair<size_t, size_t>>& pairs) {
 }
 
 void CKKSTensor::clear() {
+    this->forget_seeded();
     this->_data = TensorStorage<Ciphertext>();
     this->_batch_size = optional<double>();
     this->_init_scale = 0;
@@ -682,18 +727,30 @@ void CKKSTensor::load_proto(const CKKSTensorProto& tensor_proto) {
     }
     this->clear();
 
-    vector<Ciphertext> enc_data;
     vector<size_t> enc_shape;
 
     for (int idx = 0; idx < tensor_proto.shape_size(); ++idx) {
         enc_shape.push_back(tensor_proto.shape(idx));
     }
-    for (int idx = 0; idx < tensor_proto.ciphertexts_size(); ++idx)
-        enc_data.push_back(SEALDeserialize<Ciphertext>(
-            *this->tenseal_context()->seal_context(),
-            tensor_proto.ciphertexts(idx)));
     this->_init_scale = tensor_proto.scale();
-    this->_data = TensorStorage<Ciphertext>(enc_data, enc_shape);
+    size_t size = tensor_proto.ciphertexts_size();
+    this->_data =
+        TensorStorage<Ciphertext>(vector<Ciphertext>(size), enc_shape);
+
+    // deserialize on the dispatcher, so the ciphertexts are allocated from
+    // the memory of the workers.
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
+        for (size_t idx = start; idx < end; ++idx) {
+            this->_data.flat_ref_at(idx) = SEALDeserialize<Ciphertext>(
+                *this->tenseal_context()->seal_context(),
+                tensor_proto.ciphertexts(static_cast<int>(idx)),
+                this->tenseal_context()->memory_pool());
+        }
+        return true;
+    };
+
+    this->dispatch_jobs(worker_func, size);
+
     if (tensor_proto.batch_size())
         this->_batch_size = tensor_proto.batch_size();
 }
@@ -701,8 +758,9 @@ void CKKSTensor::load_proto(const CKKSTensorProto& tensor_proto) {
 CKKSTensorProto CKKSTensor::save_proto() const {
     CKKSTensorProto buffer;
 
+    size_t idx = 0;
     for (auto& ct : this->data()) {
-        buffer.add_ciphertexts(SEALSerialize<Ciphertext>(ct));
+        buffer.add_ciphertexts(this->serialize_ciphertext(idx++, ct));
     }
     for (auto& dim : this->shape()) {
         buffer.add_shape(dim);
@@ -751,11 +809,10 @@ shared_ptr<CKKSTensor> CKKSTensor::copy() const {
 shared_ptr<CKKSTensor> CKKSTensor::deepcopy() const {
     if (_lazy_buffer) return this->copy();
 
-    TenSEALContextProto ctx = this->tenseal_context()->save_proto(
-        /*save_public_key=*/true, /*save_secret_key=*/true,
-        /*save_galois_keys=*/true, /*save_relin_keys=*/true);
-    CKKSTensorProto vec = this->save_proto();
-    return CKKSTensor::Create(ctx, vec);
+    // the ciphertexts are copied, the context shares its keys with the copy
+    auto result = this->copy();
+    result->link_tenseal_context(this->tenseal_context()->copy());
+    return result;
 }
 
 vector<Ciphertext> CKKSTensor::data() const { return _data.data(); }
@@ -786,6 +843,7 @@ shared_ptr<CKKSTensor> CKKSTensor::broadcast(
 }
 shared_ptr<CKKSTensor> CKKSTensor::broadcast_inplace(
     const vector<size_t>& other_shape) {
+    this->forget_seeded();
     this->_data.broadcast_inplace(other_shape);
 
     return shared_from_this();
@@ -795,6 +853,7 @@ shared_ptr<CKKSTensor> CKKSTensor::transpose() const {
     return this->copy()->transpose_inplace();
 }
 shared_ptr<CKKSTensor> CKKSTensor::transpose_inplace() {
+    this->forget_seeded();
     this->_data.transpose_inplace();
 
     return shared_from_this();
@@ -135,10 +135,16 @@ class CKKSTensor : public EncryptedTensor<double, shared_ptr<CKKSTensor>>,
     CKKSTensor(const shared_ptr<const CKKSTensor>& vec,
                const TensorStorage<Ciphertext>& storage);
 
+    /**
+     * Encrypt a batch or a single value, "seeded" receives the seeded
+     *serialization of the ciphertext for the symmetric contexts.
+     **/
     static Ciphertext encrypt(const shared_ptr<TenSEALContext>& ctx,
-                              const double scale, const vector<double>& data);
+                              const double scale, const vector<double>& data,
+                              string* seeded = nullptr);
     static Ciphertext encrypt(const shared_ptr<TenSEALContext>& ctx,
-                              const double scale, const double data);
+                              const double scale, const double data,
+                              string* seeded = nullptr);
 
     enum class OP { ADD, SUB, MUL };
     void perform_op(seal::Ciphertext& ct, seal::Ciphertext other, OP op);
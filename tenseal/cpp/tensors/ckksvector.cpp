@@ -9,6 +9,15 @@ namespace tenseal {
 
 CKKSVector::CKKSVector(const shared_ptr<TenSEALContext>& ctx,
                        const CKKSVector::plain_t& vec,
+                       std::optional<double> scale)
+    : CKKSVector(ctx, vec.data_ref(), scale) {}
+
+CKKSVector::CKKSVector(const shared_ptr<TenSEALContext>& ctx,
+                       const vector<double>& vec, std::optional<double> scale)
+    : CKKSVector(ctx, gsl::span<const double>(vec), scale) {}
+
+CKKSVector::CKKSVector(const shared_ptr<TenSEALContext>& ctx,
+                       gsl::span<const double> vec,
                        std::optional<double> scale) {
     this->link_tenseal_context(ctx);
     if (scale.has_value()) {
@@ -22,9 +31,9 @@ CKKSVector::CKKSVector(const shared_ptr<TenSEALContext>& ctx,
     }
 
     auto slot_count = ctx->slot_count<CKKSEncoder>();
-    auto vec_chunks = vec.chunks(slot_count);
+    size_t n_chunks = (vec.size() + slot_count - 1) / slot_count;
 
-    if (vec_chunks.size() > 1) {
+    if (n_chunks > 1) {
         std::cout
             << "WARNING: The input does not fit in a single ciphertext, and "
                "some operations will be disabled.\n"
@@ -36,12 +45,17 @@ CKKSVector::CKKSVector(const shared_ptr<TenSEALContext>& ctx,
 
     this->_ciphertexts = vector<Ciphertext>();
     this->_sizes = vector<size_t>();
+    this->_seeded.resize(n_chunks);
 
-    for (auto& chunk : vec_chunks) {
+    for (size_t offset = 0; offset < vec.size(); offset += slot_count) {
         // Encrypts the whole vector into a single ciphertext using CKKS
-        // batching
+        // batching, the chunks are views of the input
+        auto chunk =
+            vec.subspan(offset, std::min(slot_count, vec.size() - offset));
+        string seeded;
         this->_ciphertexts.push_back(
-            CKKSVector::encrypt(ctx, this->_init_scale, chunk));
+            CKKSVector::encrypt(ctx, this->_init_scale, chunk, &seeded));
+        this->keep_seeded(this->_ciphertexts.size() - 1, std::move(seeded));
         this->_sizes.push_back(chunk.size());
     }
 }
@@ -93,7 +107,7 @@ CKKSVector::CKKSVector(const shared_ptr<const CKKSVector>& vec) {
 // }
 
 Ciphertext CKKSVector::encrypt(shared_ptr<TenSEALContext> context, double scale,
-                               plain_t pt) {
+                               gsl::span<const double> pt, string* seeded) {
     if (pt.empty()) {
         throw invalid_argument("Attempting to encrypt an empty vector");
     }
@@ -106,38 +120,45 @@ Ciphertext CKKSVector::encrypt(shared_ptr<TenSEALContext> context, double scale,
 
     Ciphertext ciphertext(*context->seal_context());
     Plaintext plaintext;
-    pt.replicate(slot_count);
-    context->encode<CKKSEncoder>(pt.data(), plaintext, scale);
-    context->encrypt(plaintext, ciphertext);
+    context->encode_replicated<CKKSEncoder>(pt, plaintext, scale);
+    if (seeded)
+        *seeded = context->encrypt_seeded(plaintext, ciphertext);
+    else
+        context->encrypt(plaintext, ciphertext);
 
     return ciphertext;
 }
 
 CKKSVector::plain_t CKKSVector::decrypt(const shared_ptr<SecretKey>& sk) const {
-    vector<double> result;
-    result.reserve(this->size());
+    auto decryptor = this->tenseal_context()->decryptor(sk);
+    vector<vector<double>> partial_results(this->_ciphertexts.size());
 
-    for (size_t idx = 0; idx < this->_ciphertexts.size(); ++idx) {
-        vector<double> partial_result;
-        partial_result.reserve(this->_sizes[idx]);
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
         Plaintext plaintext;
+        for (size_t idx = start; idx < end; ++idx) {
+            decryptor->decrypt(this->_ciphertexts[idx], plaintext);
+            this->tenseal_context()->decode<CKKSEncoder>(plaintext,
+                                                         partial_results[idx]);
+        }
+        return true;
+    };
+    this->dispatch_jobs(worker_func, this->_ciphertexts.size());
 
-        this->tenseal_context()->decrypt(*sk, this->_ciphertexts[idx],
-                                         plaintext);
-        this->tenseal_context()->decode<CKKSEncoder>(plaintext, partial_result);
-
+    vector<double> result;
+    result.reserve(this->size());
+    for (size_t idx = 0; idx < partial_results.size(); ++idx) {
         // result contains all slots of ciphertext (n/2), but we may be using
         // less we use the size to delimit the resulting plaintext vector
-        auto partial_decr =
-            vector<double>(partial_result.cbegin(),
-                           partial_result.cbegin() + this->_sizes[idx]);
-        result.insert(result.end(), partial_decr.begin(), partial_decr.end());
+        auto& partial_result = partial_results[idx];
+        result.insert(result.end(), partial_result.cbegin(),
+                      partial_result.cbegin() + this->_sizes[idx]);
     }
 
     return result;
 }
 
 shared_ptr<CKKSVector> CKKSVector::power_inplace(unsigned int power) {
+    this->forget_seeded();
     // if the power is zero, return a new encrypted vector of ones
     if (power == 0) {
         vector<double> ones(this->size(), 1);
@@ -167,6 +188,7 @@ shared_ptr<CKKSVector> CKKSVector::power_inplace(unsigned int power) {
 }
 
 shared_ptr<CKKSVector> CKKSVector::negate_inplace() {
+    this->forget_seeded();
     for (auto& ct : this->_ciphertexts)
         this->tenseal_context()->evaluator->negate_inplace(ct);
 
@@ -174,8 +196,10 @@ shared_ptr<CKKSVector> CKKSVector::negate_inplace() {
 }
 
 shared_ptr<CKKSVector> CKKSVector::square_inplace() {
+    this->forget_seeded();
     for (auto& ct : this->_ciphertexts) {
-        this->tenseal_context()->evaluator->square_inplace(ct);
+        this->tenseal_context()->evaluator->square_inplace(
+            ct, this->tenseal_context()->memory_pool());
         this->auto_relin(ct);
         this->auto_rescale(ct);
     }
@@ -185,6 +209,7 @@ shared_ptr<CKKSVector> CKKSVector::square_inplace() {
 
 shared_ptr<CKKSVector> CKKSVector::add_inplace(
     const shared_ptr<CKKSVector>& other) {
+    this->forget_seeded();
     auto to_add = other;
     if (!this->tenseal_context()->equals(to_add->tenseal_context())) {
         // Different contexts means different parameters
@@ -205,6 +230,7 @@ shared_ptr<CKKSVector> CKKSVector::add_inplace(
 
 shared_ptr<CKKSVector> CKKSVector::sub_inplace(
     const shared_ptr<CKKSVector>& other) {
+    this->forget_seeded();
     auto to_sub = other;
     if (!this->tenseal_context()->equals(to_sub->tenseal_context())) {
         // Different contexts means different parameters
@@ -297,6 +323,7 @@ void dump_ciphertext_flat(const seal::Ciphertext& ct,
 
 shared_ptr<CKKSVector> CKKSVector::mul_inplace(
     const shared_ptr<CKKSVector>& other) {
+    this->forget_seeded();
     auto to_mul = other;
     printf("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa!!!");
     if (!this->tenseal_context()->equals(to_mul->tenseal_context())) {
@@ -310,7 +337,8 @@ shared_ptr<CKKSVector> CKKSVector::mul_inplace(
         this->auto_same_mod(to_mul->_ciphertexts[idx], _ciphertexts[idx]);
 
         this->tenseal_context()->evaluator->multiply_inplace(
-            this->_ciphertexts[idx], to_mul->_ciphertexts[idx]);
+            this->_ciphertexts[idx], to_mul->_ciphertexts[idx],
+            this->tenseal_context()->memory_pool());
         print_ciphertext_raw(this->_ciphertexts[idx], *this->tenseal_context()->seal_context(), "after mul");
 
         this->auto_relin(_ciphertexts[idx]);
@@ -343,6 +371,7 @@ shared_ptr<CKKSVector> CKKSVector::dot_plain_inplace(const plain_t& to_mul) {
 }
 
 shared_ptr<CKKSVector> CKKSVector::sum_inplace(size_t /*axis = 0*/) {
+    this->forget_seeded();
     vector<Ciphertext> interm_sum;
     size_t size = this->_ciphertexts.size();
     interm_sum.resize(size);
@@ -369,6 +398,7 @@ shared_ptr<CKKSVector> CKKSVector::sum_inplace(size_t /*axis = 0*/) {
 
 shared_ptr<CKKSVector> CKKSVector::add_plain_inplace(
     const plain_t& vector_to_add) {
+    this->forget_seeded();
     if (this->size() != vector_to_add.size()) {
         throw invalid_argument("can't add vectors of different sizes");
     }
@@ -383,6 +413,7 @@ shared_ptr<CKKSVector> CKKSVector::add_plain_inplace(
 }
 
 shared_ptr<CKKSVector> CKKSVector::add_plain_inplace(const double& to_add) {
+    this->forget_seeded();
     for (auto& ct : this->_ciphertexts) this->_add_plain_inplace(ct, to_add);
     return shared_from_this();
 }
@@ -390,14 +421,15 @@ shared_ptr<CKKSVector> CKKSVector::add_plain_inplace(const double& to_add) {
 template <typename T>
 void CKKSVector::_add_plain_inplace(Ciphertext& ct, const T& to_add) {
     Plaintext plaintext;
-    this->tenseal_context()->encode<CKKSEncoder>(to_add, plaintext,
-                                                 this->_init_scale);
-    this->auto_same_mod(plaintext, ct);
-    this->tenseal_context()->evaluator->add_plain_inplace(ct, plaintext);
+    this->tenseal_context()->encode<CKKSEncoder>(
+        to_add, plaintext, this->_init_scale, this->plain_parms_id(ct));
+    this->tenseal_context()->evaluator->add_plain_inplace(
+        ct, plaintext, this->tenseal_context()->memory_pool());
 }
 
 shared_ptr<CKKSVector> CKKSVector::sub_plain_inplace(
     const plain_t& vector_to_sub) {
+    this->forget_seeded();
     if (this->size() != vector_to_sub.size()) {
         throw invalid_argument("can't sub vectors of different sizes");
     }
@@ -413,6 +445,7 @@ shared_ptr<CKKSVector> CKKSVector::sub_plain_inplace(
 }
 
 shared_ptr<CKKSVector> CKKSVector::sub_plain_inplace(const double& to_sub) {
+    this->forget_seeded();
     for (auto& ct : this->_ciphertexts) this->_sub_plain_inplace(ct, to_sub);
     return shared_from_this();
 }
@@ -420,15 +453,15 @@ shared_ptr<CKKSVector> CKKSVector::sub_plain_inplace(const double& to_sub) {
 template <typename T>
 void CKKSVector::_sub_plain_inplace(Ciphertext& ct, const T& to_sub) {
     Plaintext plaintext;
-    this->tenseal_context()->encode<CKKSEncoder>(to_sub, plaintext,
-                                                 this->_init_scale);
-
-    this->auto_same_mod(plaintext, ct);
-    this->tenseal_context()->evaluator->sub_plain_inplace(ct, plaintext);
+    this->tenseal_context()->encode<CKKSEncoder>(
+        to_sub, plaintext, this->_init_scale, this->plain_parms_id(ct));
+    this->tenseal_context()->evaluator->sub_plain_inplace(
+        ct, plaintext, this->tenseal_context()->memory_pool());
 }
 
 shared_ptr<CKKSVector> CKKSVector::mul_plain_inplace(
     const plain_t& vector_to_mul) {
+    this->forget_seeded();
     if (this->size() != vector_to_mul.size()) {
         throw invalid_argument("can't multiply vectors of different sizes");
     }
@@ -444,6 +477,7 @@ shared_ptr<CKKSVector> CKKSVector::mul_plain_inplace(
 }
 
 shared_ptr<CKKSVector> CKKSVector::mul_plain_inplace(const double& to_mul) {
+    this->forget_seeded();
     for (auto& ct : this->_ciphertexts) this->_mul_plain_inplace(ct, to_mul);
     return shared_from_this();
 }
@@ -451,13 +485,14 @@ shared_ptr<CKKSVector> CKKSVector::mul_plain_inplace(const double& to_mul) {
 template <typename T>
 void CKKSVector::_mul_plain_inplace(Ciphertext& ct, const T& to_mul) {
     Plaintext plaintext;
-    this->tenseal_context()->encode<CKKSEncoder>(to_mul, plaintext,
-                                                 this->_init_scale);
+    // encoded at the level of the ciphertext, the same operands, e.g. model
+    // weights, are then served by the encode cache at that level
+    this->tenseal_context()->encode<CKKSEncoder>(
+        to_mul, plaintext, this->_init_scale, this->plain_parms_id(ct));
 
-    this->auto_same_mod(plaintext, ct);
     try {
-        this->tenseal_context()->evaluator->multiply_plain_inplace(ct,
-                                                                   plaintext);
+        this->tenseal_context()->evaluator->multiply_plain_inplace(
+            ct, plaintext, this->tenseal_context()->memory_pool());
     } catch (const std::logic_error& e) {
         if (strcmp(e.what(), "result ciphertext is transparent") == 0) {
             // replace by encryption of zero
@@ -474,6 +509,7 @@ void CKKSVector::_mul_plain_inplace(Ciphertext& ct, const T& to_mul) {
 
 shared_ptr<CKKSVector> CKKSVector::matmul_plain_inplace(
     const CKKSVector::plain_t& matrix) {
+    this->forget_seeded();
     if (this->_ciphertexts.size() != 1)
         throw invalid_argument("can't execute matmul_plain on chunked vectors");
 
@@ -485,8 +521,57 @@ shared_ptr<CKKSVector> CKKSVector::matmul_plain_inplace(
     return shared_from_this();
 }
 
+shared_ptr<CKKSVector> CKKSVector::matmul_plain(
+    const shared_ptr<EncodedMatrix>& matrix) const {
+    return this->copy()->matmul_plain_inplace(matrix);
+}
+
+shared_ptr<CKKSVector> CKKSVector::matmul_plain_inplace(
+    const shared_ptr<EncodedMatrix>& matrix) {
+    this->forget_seeded();
+    if (matrix == nullptr) throw invalid_argument("invalid matrix");
+    if (this->_ciphertexts.size() != 1)
+        throw invalid_argument("can't execute matmul_plain on chunked vectors");
+    if (this->size() != matrix->rows())
+        throw invalid_argument("matrix shape doesn't match with vector size");
+
+    auto seal_context = this->tenseal_context()->seal_context();
+    if (matrix->tenseal_context()->seal_context()->key_parms_id() !=
+        seal_context->key_parms_id())
+        throw invalid_argument(
+            "the matrix was encoded with different encryption parameters");
+
+    auto& ct = this->_ciphertexts[0];
+    if (seal_context->get_context_data(ct.parms_id())->chain_index() >
+        seal_context->get_context_data(matrix->parms_id())->chain_index())
+        this->tenseal_context()->evaluator->mod_switch_to_inplace(
+            ct, matrix->parms_id(), this->tenseal_context()->memory_pool());
+
+    auto diagonals = matrix->diagonals(ct.parms_id());
+    // the diagonals by index, nullptr for the zero ones
+    vector<const Plaintext*> by_index(matrix->rows(), nullptr);
+    for (size_t j = 0; j < diagonals->size(); j++)
+        by_index[matrix->indices()[j]] = &(*diagonals)[j];
+    auto diagonal = [&](size_t k, Plaintext&) { return by_index[k]; };
+
+    auto steps = matmul_plain_steps(matrix->rows());
+    if (matrix->baby_steps())
+        this->_ciphertexts = {this->bsgs_ct_vector_matmul(
+            matrix->rows(), matrix->baby_steps(), diagonal, matrix->scale(),
+            steps)};
+    else
+        this->_ciphertexts = {this->diagonal_ct_vector_matmul(
+            matrix->rows(), diagonal, matrix->scale(), steps)};
+
+    this->_sizes = {matrix->cols()};
+    this->auto_rescale(_ciphertexts[0]);
+
+    return shared_from_this();
+}
+
 shared_ptr<CKKSVector> CKKSVector::polyval_inplace(
     const vector<double>& coefficients) {
+    this->forget_seeded();
     if (coefficients.size() == 0) {
         throw invalid_argument(
             "the coefficients vector need to have at least one element");
@@ -530,6 +615,7 @@ shared_ptr<CKKSVector> CKKSVector::polyval_inplace(
 
     // coefficients[1] * x + ... + coefficients[degree] * x^(degree)
     for (int i = 1; i <= degree; i++) {
+        sync::check_cancellation();
         if (coefficients[i] == 0.0) continue;
         x = compute_polynomial_term(i, coefficients[i], x_squares);
         result->add_inplace(x);
@@ -541,6 +627,7 @@ shared_ptr<CKKSVector> CKKSVector::polyval_inplace(
 
 shared_ptr<CKKSVector> CKKSVector::conv2d_im2col_inplace(
     const CKKSVector::plain_t& kernel, const size_t windows_nb) {
+    this->forget_seeded();
     if (this->_ciphertexts.size() != 1)
         throw invalid_argument(
             "can't execute conv2d_im2col on chunked vectors");
@@ -561,6 +648,7 @@ shared_ptr<CKKSVector> CKKSVector::conv2d_im2col_inplace(
 
 shared_ptr<CKKSVector> CKKSVector::enc_matmul_plain_inplace(
     const CKKSVector::plain_t& plain_vec, const size_t rows_nb) {
+    this->forget_seeded();
     if (plain_vec.empty()) {
         throw invalid_argument("Plain vector can't be empty");
     }
@@ -599,16 +687,14 @@ shared_ptr<CKKSVector> CKKSVector::enc_matmul_plain_inplace(
 
     this->mul_plain_inplace(new_plain_vec);
 
-    auto galois_keys = this->tenseal_context()->galois_keys();
+    auto steps = enc_matmul_steps(chunks_nb, rows_nb);
+    auto galois_keys = this->tenseal_context()->galois_keys(steps);
 
     auto tmp = this->copy();
 
-    while (chunks_nb > 1) {
+    for (int step : steps) {
         tmp = this->copy();
-        chunks_nb = static_cast<int>(
-            1 << (static_cast<size_t>(ceil(log2(chunks_nb))) - 1));
-        tmp->rotate_vector_inplace(static_cast<int>(rows_nb * chunks_nb),
-                                   *galois_keys);
+        tmp->rotate_vector_inplace(step, *galois_keys);
         this->add_inplace(tmp);
     }
 
@@ -618,6 +704,7 @@ shared_ptr<CKKSVector> CKKSVector::enc_matmul_plain_inplace(
 }
 
 shared_ptr<CKKSVector> CKKSVector::replicate_first_slot_inplace(size_t n) {
+    this->forget_seeded();
     auto slot_count = this->tenseal_context()->slot_count<CKKSEncoder>();
     // mask
     vector<double> mask(min(slot_count, n), 0);
@@ -625,13 +712,14 @@ shared_ptr<CKKSVector> CKKSVector::replicate_first_slot_inplace(size_t n) {
     this->_mul_plain_inplace(this->_ciphertexts[0], mask);
     Ciphertext masked = this->_ciphertexts[0];
 
-    auto galois_keys = this->tenseal_context()->galois_keys();
-
     auto replicator = [&](Ciphertext ct, size_t n_repl) -> Ciphertext {
+        auto steps = replicate_steps(n_repl);
+        auto galois_keys = this->tenseal_context()->galois_keys(steps);
         Ciphertext tmp = ct;
-        for (size_t i = 0; i < (size_t)ceil(log2(n_repl)); i++) {
+        for (int step : steps) {
             this->tenseal_context()->evaluator->rotate_vector_inplace(
-                tmp, static_cast<int>(-pow(2, i)), *galois_keys);
+                tmp, step, *galois_keys,
+                this->tenseal_context()->memory_pool());
             this->tenseal_context()->evaluator->add_inplace(ct, tmp);
             tmp = ct;
         }
@@ -673,12 +761,25 @@ void CKKSVector::load_proto(const CKKSVectorProto& vec) {
     }
 
     this->_sizes = vector<size_t>();
+    this->forget_seeded();
     this->_ciphertexts = vector<Ciphertext>();
 
     for (auto& sz : vec.sizes()) this->_sizes.push_back(sz);
-    for (auto& ct : vec.ciphertexts())
-        this->_ciphertexts.push_back(SEALDeserialize<Ciphertext>(
-            *this->tenseal_context()->seal_context(), ct));
+    this->_ciphertexts.resize(vec.ciphertexts_size());
+
+    // deserialize on the dispatcher, so the ciphertexts are allocated from
+    // the memory of the workers.
+    task_t worker_func = [&](size_t start, size_t end) -> bool {
+        for (size_t idx = start; idx < end; ++idx) {
+            this->_ciphertexts[idx] = SEALDeserialize<Ciphertext>(
+                *this->tenseal_context()->seal_context(),
+                vec.ciphertexts(static_cast<int>(idx)),
+                this->tenseal_context()->memory_pool());
+        }
+        return true;
+    };
+
+    this->dispatch_jobs(worker_func, this->_ciphertexts.size());
 
     this->_init_scale = vec.scale();
 }
@@ -686,8 +787,9 @@ void CKKSVector::load_proto(const CKKSVectorProto& vec) {
 CKKSVectorProto CKKSVector::save_proto() const {
     CKKSVectorProto buffer;
 
-    for (auto& ct : this->_ciphertexts) {
-        buffer.add_ciphertexts(SEALSerialize<Ciphertext>(ct));
+    for (size_t idx = 0; idx < this->_ciphertexts.size(); ++idx) {
+        buffer.add_ciphertexts(
+            this->serialize_ciphertext(idx, this->_ciphertexts[idx]));
     }
     for (auto& sz : this->_sizes) {
         buffer.add_sizes(sz);
@@ -735,11 +837,10 @@ shared_ptr<CKKSVector> CKKSVector::copy() const {
 shared_ptr<CKKSVector> CKKSVector::deepcopy() const {
     if (_lazy_buffer) return this->copy();
 
-    TenSEALContextProto ctx = this->tenseal_context()->save_proto(
-        /*save_public_key=*/true, /*save_secret_key=*/true,
-        /*save_galois_keys=*/true, /*save_relin_keys=*/true);
-    CKKSVectorProto vec = this->save_proto();
-    return CKKSVector::Create(ctx, vec);
+    // the ciphertexts are copied, the context shares its keys with the copy
+    auto result = this->copy();
+    result->link_tenseal_context(this->tenseal_context()->copy());
+    return result;
 }
 
 std::vector<std::vector<std::vector<uint64_t>>> CKKSVector::get_ckks_ciphertext_values() {
@@ -822,13 +923,13 @@ shared_ptr<CKKSVector> CKKSVector::CKKSVector_from_raw(
 
 shared_ptr<CKKSVector> CKKSVector::rotate(int steps) const {
     auto context = this->tenseal_context();
-    if (!context->galois_keys()) {
+    auto galois_keys = context->galois_keys({steps});
+    if (!galois_keys) {
         throw std::runtime_error("Galois keys not set. Call generate_galois_keys() first.");
     }
 
     seal::Ciphertext rotated;
-    auto galois_keys = this->tenseal_context()->galois_keys();
-    context->evaluator->rotate_vector(this->ciphertext()[0], steps, *galois_keys, rotated);
+    context->evaluator->rotate_vector(this->ciphertext()[0], steps, *galois_keys, rotated, context->memory_pool());
 
     std::vector<seal::Ciphertext> ciphertexts = {rotated};
     std::vector<size_t> shape = { this->size() };
@@ -1,6 +1,7 @@
 #ifndef TENSEAL_TENSOR_CKKSVECTOR_H
 #define TENSEAL_TENSOR_CKKSVECTOR_H
 
+#include "tenseal/cpp/tensors/encoded_matrix.h"
 #include "tenseal/cpp/tensors/encrypted_vector.h"
 #include "tenseal/proto/tensors.pb.h"
 
@@ -20,6 +21,10 @@ class CKKSVector
     using encrypted_t = shared_ptr<CKKSVector>;
     using plain_t = PlainTensor<double>;
     using EncryptedVector<double, shared_ptr<CKKSVector>, CKKSEncoder>::decrypt;
+    using EncryptedVector<double, shared_ptr<CKKSVector>,
+                          CKKSEncoder>::matmul_plain;
+    using EncryptedVector<double, shared_ptr<CKKSVector>,
+                          CKKSEncoder>::matmul_plain_async;
 
     template <typename... Args>
     static encrypted_t Create(Args&&... args) {
@@ -94,6 +99,18 @@ class CKKSVector
      * Encrypted Vector multiplication with plain matrix.
      **/
     encrypted_t matmul_plain_inplace(const plain_t& matrix) override;
+    /**
+     * Encrypted Vector multiplication with a matrix encoded beforehand. The
+     *vector is switched down to the level of the matrix if it's above it.
+     **/
+    encrypted_t matmul_plain(const shared_ptr<EncodedMatrix>& matrix) const;
+    encrypted_t matmul_plain_inplace(const shared_ptr<EncodedMatrix>& matrix);
+    future<encrypted_t> matmul_plain_async(
+        const shared_ptr<EncodedMatrix>& matrix) const {
+        return this->run_async([matrix](encrypted_t t) {
+            return t->matmul_plain_inplace(matrix);
+        });
+    }
 
     /**
      * Encrypted Matrix multiplication with plain vector.
@@ -149,6 +166,14 @@ class CKKSVector
 
     CKKSVector(const shared_ptr<TenSEALContext>& ctx, const plain_t& vec,
                optional<double> scale = {});
+    /**
+     * Encrypt the values of a caller-owned buffer, e.g. a NumPy array,
+     *without copying them.
+     **/
+    CKKSVector(const shared_ptr<TenSEALContext>& ctx,
+               gsl::span<const double> vec, optional<double> scale = {});
+    CKKSVector(const shared_ptr<TenSEALContext>& ctx, const vector<double>& vec,
+               optional<double> scale = {});
     CKKSVector(const shared_ptr<TenSEALContext>& ctx, const string& vec);
     CKKSVector(const string& vec);
     CKKSVector(const TenSEALContextProto& ctx, const CKKSVectorProto& vec);
@@ -156,8 +181,13 @@ class CKKSVector
                const CKKSVectorProto& vec);
     CKKSVector(const shared_ptr<const CKKSVector>& vec);
 
+    /**
+     * Encrypt a chunk, "seeded" receives the seeded serialization of the
+     *ciphertext for the symmetric contexts.
+     **/
     static Ciphertext encrypt(shared_ptr<TenSEALContext> context, double scale,
-                              plain_t pt);
+                              gsl::span<const double> pt,
+                              string* seeded = nullptr);
 
     void load_proto(const CKKSVectorProto& buffer);
     CKKSVectorProto save_proto() const;
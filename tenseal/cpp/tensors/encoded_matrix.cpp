@@ -0,0 +1,113 @@
+#include "tenseal/cpp/tensors/encoded_matrix.h"
+
+#include "tenseal/cpp/tensors/utils/utils.h"
+#include "tenseal/cpp/utils/parallel.h"
+
+namespace tenseal {
+
+using namespace seal;
+using namespace std;
+
+shared_ptr<EncodedMatrix> EncodedMatrix::Create(
+    const shared_ptr<TenSEALContext>& ctx, const PlainTensor<double>& matrix,
+    optional<double> scale, optional<parms_id_type> parms_id) {
+    return shared_ptr<EncodedMatrix>(
+        new EncodedMatrix(ctx, matrix, scale, parms_id));
+}
+
+EncodedMatrix::EncodedMatrix(const shared_ptr<TenSEALContext>& ctx,
+                             const PlainTensor<double>& matrix,
+                             optional<double> scale,
+                             optional<parms_id_type> parms_id) {
+    if (ctx == nullptr) throw invalid_argument("invalid context");
+    if (matrix.shape().size() != 2)
+        throw invalid_argument("can only encode a matrix");
+
+    _context = ctx;
+    _rows = matrix.shape()[0];
+    _cols = matrix.shape()[1];
+    _scale = scale.has_value() ? scale.value() : ctx->global_scale();
+    _parms_id = parms_id.value_or(ctx->seal_context()->first_parms_id());
+    if (!ctx->seal_context()->get_context_data(_parms_id))
+        throw invalid_argument("invalid parms_id");
+
+    size_t slot_count = ctx->slot_count<CKKSEncoder>();
+    if (_rows == 0 || _rows > slot_count || _cols > slot_count)
+        throw invalid_argument("the matrix doesn't fit in a ciphertext");
+
+    _baby_steps = bsgs_baby_steps(_rows);
+
+    // a dedicated encoder keeps the diagonals out of the encode cache
+    CKKSEncoder encoder(*ctx->seal_context());
+    vector<optional<Plaintext>> encoded(_rows);
+    auto worker_func = [&](size_t start, size_t end) {
+        for (size_t k = start; k < end; k++) {
+            auto diag = matrix.matmul_diagonal(
+                k, slot_count, bsgs_diagonal_shift(k, _baby_steps));
+            if (diag.empty()) continue;
+
+            encoded[k].emplace();
+            encoder.encode(diag, _parms_id, _scale, *encoded[k],
+                           sync::ThreadPool::memory_pool());
+        }
+    };
+
+    size_t n_jobs = sync::parallel_jobs(_rows, ctx->dispatcher_size());
+    if (n_jobs == 1) {
+        sync::check_cancellation();
+        worker_func(0, _rows);
+    } else {
+        try {
+            sync::parallel_for(*ctx->dispatcher(), _rows, n_jobs,
+                               worker_func);
+        } catch (sync::operation_cancelled&) {
+            throw;
+        } catch (std::exception& e) {
+            throw invalid_argument(e.what());
+        }
+    }
+
+    vector<Plaintext> diagonals;
+    for (size_t k = 0; k < _rows; k++) {
+        if (!encoded[k]) continue;
+        _indices.push_back(k);
+        diagonals.push_back(std::move(*encoded[k]));
+    }
+    _diagonals = make_shared<const vector<Plaintext>>(std::move(diagonals));
+}
+
+shared_ptr<const vector<Plaintext>> EncodedMatrix::diagonals(
+    const parms_id_type& parms_id) const {
+    if (parms_id == _parms_id) return _diagonals;
+
+    std::scoped_lock lock{_mutex};
+    for (auto it = _derived.begin(); it != _derived.end(); ++it) {
+        if (it->first != parms_id) continue;
+        _derived.splice(_derived.begin(), _derived, it);
+        return it->second;
+    }
+
+    auto seal_context = _context->seal_context();
+    auto context_data = seal_context->get_context_data(parms_id);
+    if (!context_data ||
+        context_data->chain_index() >
+            seal_context->get_context_data(_parms_id)->chain_index())
+        throw invalid_argument(
+            "the matrix was encoded at a lower level than requested");
+
+    auto diagonals = *_diagonals;
+    for (auto& pt : diagonals)
+        _context->evaluator->mod_switch_to_inplace(pt, parms_id);
+
+    auto result = make_shared<const vector<Plaintext>>(std::move(diagonals));
+    _derived.emplace_front(parms_id, result);
+    if (_derived.size() > derived_levels) _derived.pop_back();
+    return result;
+}
+
+void EncodedMatrix::clear() {
+    std::scoped_lock lock{_mutex};
+    _derived.clear();
+}
+
+}  // namespace tenseal
@@ -0,0 +1,99 @@
+#ifndef TENSEAL_TENSOR_ENCODED_MATRIX_H
+#define TENSEAL_TENSOR_ENCODED_MATRIX_H
+
+#include <list>
+#include <mutex>
+#include <utility>
+
+#include "seal/seal.h"
+#include "tenseal/cpp/context/tensealcontext.h"
+#include "tenseal/cpp/tensors/plain_tensor.h"
+
+namespace tenseal {
+
+using namespace seal;
+using namespace std;
+
+/**
+ * Plain matrix in the form used by the diagonal method of
+ *CKKSVector::matmul_plain, or its baby-step giant-step variant for the large
+ *matrices. Its nonzero diagonals are replicated, rotated and encoded once,
+ *then reused by every multiplication with the matrix, e.g. the weights of a
+ *model applied to many inputs.
+ **/
+class EncodedMatrix {
+   public:
+    /**
+     * Encode the diagonals of "matrix" at "scale" and "parms_id", which
+     *default to the global scale and the top of the modulus chain.
+     * @throws invalid_argument if "matrix" isn't a matrix or doesn't fit in
+     *the slots of a ciphertext.
+     **/
+    static shared_ptr<EncodedMatrix> Create(
+        const shared_ptr<TenSEALContext>& ctx,
+        const PlainTensor<double>& matrix, optional<double> scale = {},
+        optional<parms_id_type> parms_id = {});
+
+    EncodedMatrix(const EncodedMatrix&) = delete;
+    EncodedMatrix& operator=(const EncodedMatrix&) = delete;
+
+    size_t rows() const { return _rows; }
+    size_t cols() const { return _cols; }
+    vector<size_t> shape() const { return {_rows, _cols}; }
+    double scale() const { return _scale; }
+    /**
+     * @returns the level the diagonals were encoded at.
+     **/
+    const parms_id_type& parms_id() const { return _parms_id; }
+    /**
+     * @returns the indices of the nonzero diagonals, in their order.
+     **/
+    const vector<size_t>& indices() const { return _indices; }
+    /**
+     * @returns the baby steps of the baby-step giant-step method the diagonals
+     *were rotated for, 0 for the diagonal method.
+     **/
+    size_t baby_steps() const { return _baby_steps; }
+    /**
+     * @returns the diagonals at "parms_id". The diagonals of a lower level are
+     *switched down from the encoded ones on first use, then kept for the
+     *derived_levels most recently used levels.
+     * @throws invalid_argument if "parms_id" is above the encoded level.
+     **/
+    shared_ptr<const vector<Plaintext>> diagonals(
+        const parms_id_type& parms_id) const;
+    /**
+     * Release the diagonals switched down to lower levels, only the encoded
+     *ones are kept.
+     **/
+    void clear();
+    /**
+     * Number of lower levels whose diagonals are kept.
+     **/
+    static constexpr size_t derived_levels = 2;
+
+    shared_ptr<TenSEALContext> tenseal_context() const { return _context; }
+
+   private:
+    EncodedMatrix(const shared_ptr<TenSEALContext>& ctx,
+                  const PlainTensor<double>& matrix, optional<double> scale,
+                  optional<parms_id_type> parms_id);
+
+    shared_ptr<TenSEALContext> _context;
+    size_t _rows;
+    size_t _cols;
+    double _scale;
+    parms_id_type _parms_id;
+    size_t _baby_steps;
+    vector<size_t> _indices;
+
+    shared_ptr<const vector<Plaintext>> _diagonals;
+    mutable std::mutex _mutex;
+    // the diagonals of the lower levels, the most recently used first
+    mutable list<pair<parms_id_type, shared_ptr<const vector<Plaintext>>>>
+        _derived;
+};
+
+}  // namespace tenseal
+
+#endif
@@ -4,6 +4,7 @@
 #include "tenseal/cpp/context/tensealcontext.h"
 #include "tenseal/cpp/tensors/plain_tensor.h"
 #include "tenseal/cpp/tensors/utils/utils.h"
+#include "tenseal/cpp/utils/parallel.h"
 #include "tenseal/cpp/utils/proto.h"
 #include "tenseal/cpp/utils/serialization.h"
 
@@ -147,6 +148,78 @@ class EncryptedTensor {
     };
     virtual encrypted_t polyval_inplace(
         const vector<plain_data_t>& coefficients) = 0;
+    /**
+     * Asynchronous versions of the operations above. The operation runs on a
+     *copy of the tensor on the context dispatcher, so independent operations
+     *can overlap. The encrypted operands must be left unchanged until the
+     *returned future is ready.
+     **/
+    future<encrypted_t> negate_async() const {
+        return run_async([](encrypted_t t) { return t->negate_inplace(); });
+    }
+    future<encrypted_t> square_async() const {
+        return run_async([](encrypted_t t) { return t->square_inplace(); });
+    }
+    future<encrypted_t> power_async(unsigned int power) const {
+        return run_async(
+            [power](encrypted_t t) { return t->power_inplace(power); });
+    }
+    future<encrypted_t> add_async(const encrypted_t& to_add) const {
+        return run_async(
+            [to_add](encrypted_t t) { return t->add_inplace(to_add); });
+    }
+    future<encrypted_t> sub_async(const encrypted_t& to_sub) const {
+        return run_async(
+            [to_sub](encrypted_t t) { return t->sub_inplace(to_sub); });
+    }
+    future<encrypted_t> mul_async(const encrypted_t& to_mul) const {
+        return run_async(
+            [to_mul](encrypted_t t) { return t->mul_inplace(to_mul); });
+    }
+    future<encrypted_t> dot_async(const encrypted_t& to_mul) const {
+        return run_async(
+            [to_mul](encrypted_t t) { return t->dot_inplace(to_mul); });
+    }
+    future<encrypted_t> matmul_async(const encrypted_t& to_mul) const {
+        return run_async(
+            [to_mul](encrypted_t t) { return t->matmul_inplace(to_mul); });
+    }
+    template <typename T>
+    future<encrypted_t> add_plain_async(const T& to_add) const {
+        return run_async(
+            [to_add](encrypted_t t) { return t->add_plain_inplace(to_add); });
+    }
+    template <typename T>
+    future<encrypted_t> sub_plain_async(const T& to_sub) const {
+        return run_async(
+            [to_sub](encrypted_t t) { return t->sub_plain_inplace(to_sub); });
+    }
+    template <typename T>
+    future<encrypted_t> mul_plain_async(const T& to_mul) const {
+        return run_async(
+            [to_mul](encrypted_t t) { return t->mul_plain_inplace(to_mul); });
+    }
+    future<encrypted_t> dot_plain_async(
+        const PlainTensor<plain_data_t>& to_mul) const {
+        return run_async(
+            [to_mul](encrypted_t t) { return t->dot_plain_inplace(to_mul); });
+    }
+    future<encrypted_t> matmul_plain_async(
+        const PlainTensor<plain_data_t>& to_mul) const {
+        return run_async([to_mul](encrypted_t t) {
+            return t->matmul_plain_inplace(to_mul);
+        });
+    }
+    future<encrypted_t> sum_async(size_t axis = 0) const {
+        return run_async(
+            [axis](encrypted_t t) { return t->sum_inplace(axis); });
+    }
+    future<encrypted_t> polyval_async(
+        const vector<plain_data_t>& coefficients) const {
+        return run_async([coefficients](encrypted_t t) {
+            return t->polyval_inplace(coefficients);
+        });
+    }
     /**
      * Load/Save the Tensor from/to a serialized protobuffer.
      **/
@@ -190,7 +263,8 @@ class EncryptedTensor {
     void auto_relin(Ciphertext& ct) {
         if (!this->tenseal_context()->auto_relin()) return;
         this->tenseal_context()->evaluator->relinearize_inplace(
-            ct, *this->tenseal_context()->relin_keys());
+            ct, *this->tenseal_context()->relin_keys(),
+            this->tenseal_context()->memory_pool());
     }
     void auto_relin(vector<Ciphertext>& cts) {
         if (!this->tenseal_context()->auto_relin()) return;
@@ -202,7 +276,8 @@ class EncryptedTensor {
     void auto_rescale(Ciphertext& ct) {
         if (!this->tenseal_context()->auto_rescale()) return;
 
-        this->tenseal_context()->evaluator->rescale_to_next_inplace(ct);
+        this->tenseal_context()->evaluator->rescale_to_next_inplace(
+            ct, this->tenseal_context()->memory_pool());
         ct.scale() = this->scale();
     }
     void auto_rescale(vector<Ciphertext>& cts) {
@@ -211,6 +286,16 @@ class EncryptedTensor {
         for (auto& ct : cts) auto_rescale(ct);
     }
     virtual double scale() const = 0;
+    /**
+     * @returns the parms_id a plain operand of "ct" is encoded at. With
+     *auto_mod_switch, it's the level of the ciphertext, sparing the NTTs over
+     *the primes it already dropped. Otherwise, it's the top of the modulus
+     *chain, and SEAL rejects operands at a different level.
+     **/
+    parms_id_type plain_parms_id(const Ciphertext& ct) const {
+        if (this->tenseal_context()->auto_mod_switch()) return ct.parms_id();
+        return this->tenseal_context()->seal_context()->first_parms_id();
+    }
     /**
      * Apply modulus switching to the ciphertext (or plaintext) having the
      *higher modulus.
@@ -261,46 +346,89 @@ class EncryptedTensor {
 
         if (ct_idx > other_idx) {
             this->tenseal_context()->evaluator->mod_switch_to_inplace(
-                ct, other.parms_id());
+                ct, other.parms_id(), this->tenseal_context()->memory_pool());
         } else {
             this->tenseal_context()->evaluator->mod_switch_to_inplace(
-                other, ct.parms_id());
+                other, ct.parms_id(), this->tenseal_context()->memory_pool());
         }
     }
     virtual ~EncryptedTensor(){};
 
    protected:
     optional<string> _lazy_buffer;
+    /**
+     * Seeded serializations of the freshly encrypted ciphertexts, indexed
+     *like the ciphertexts. Only filled by the symmetric contexts, and dropped
+     *by the operations modifying the ciphertexts in place. They are kept
+     *next to the expanded ciphertexts, which every operation reads directly,
+     *so a fresh tensor holds both until it's modified.
+     **/
+    vector<string> _seeded;
+
+    /**
+     * Keep the seeded serialization of the ciphertext at "idx", "_seeded"
+     *must already be large enough.
+     **/
+    void keep_seeded(size_t idx, string seeded) {
+        if (seeded.empty()) return;
+        _seeded.at(idx) = std::move(seeded);
+    }
+    /**
+     * Drop the seeded serializations, the ciphertexts are about to change.
+     **/
+    void forget_seeded() { vector<string>().swap(_seeded); }
+    /**
+     * @returns the serialization of the ciphertext at "idx", in its seeded
+     *form if it wasn't modified since it was encrypted.
+     **/
+    string serialize_ciphertext(size_t idx, const Ciphertext& ct) const {
+        if (idx < _seeded.size() && !_seeded[idx].empty()) return _seeded[idx];
+        return SEALSerialize<Ciphertext>(ct);
+    }
 
-    void dispatch_jobs(task_t& worker_func, size_t total_tasks) {
+    /**
+     * Enqueue op(copy) on the context dispatcher, "copy" being a copy of the
+     *current tensor made by the calling thread. The operation observes the
+     *cancellation token of the calling thread.
+     **/
+    template <typename F>
+    future<encrypted_t> run_async(F&& op) const {
+        return this->tenseal_context()->dispatcher()->enqueue_task(
+            [op = std::forward<F>(op),
+             token = sync::cancellation_token::current()](encrypted_t t) {
+                sync::cancellation_scope scope(token);
+                sync::check_cancellation();
+                return op(t);
+            },
+            this->copy());
+    }
+
+    /**
+     * Run worker_func over [0, total_tasks) on the context dispatcher, in
+     *chunks of at least "grain" tasks.
+     * @throws invalid_argument if any of the chunks failed.
+     * @throws operation_cancelled if the cancellation token of the calling
+     *thread was cancelled.
+     **/
+    void dispatch_jobs(task_t& worker_func, size_t total_tasks,
+                       size_t grain = 1) const {
+        auto ctx = this->tenseal_context();
         size_t n_jobs =
-            std::min(total_tasks, this->tenseal_context()->dispatcher_size());
+            sync::parallel_jobs(total_tasks, ctx->dispatcher_size(), grain);
 
         if (n_jobs == 1) {
+            sync::check_cancellation();
             worker_func(0, total_tasks);
             return;
         }
 
-        size_t batch_size = (total_tasks + n_jobs - 1) / n_jobs;
-        vector<future<bool>> futures;
-        for (size_t i = 0; i < n_jobs; i++) {
-            futures.push_back(
-                this->tenseal_context()->dispatcher()->enqueue_task(
-                    worker_func, i * batch_size,
-                    std::min((i + 1) * batch_size, total_tasks)));
-        }
-
-        std::optional<std::string> fail;
-        for (size_t i = 0; i < futures.size(); i++) {
-            try {
-                futures[i].get();
-            } catch (std::exception& e) {
-                fail = e.what();
-            }
-        }
-
-        if (fail) {
-            throw invalid_argument(fail.value());
+        try {
+            sync::parallel_for(*ctx->dispatcher(), total_tasks, n_jobs,
+                               worker_func, grain);
+        } catch (sync::operation_cancelled&) {
+            throw;
+        } catch (std::exception& e) {
+            throw invalid_argument(e.what());
         }
     }
 
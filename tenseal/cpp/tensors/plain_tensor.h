@@ -138,6 +138,25 @@ class PlainTensor {
 
         return t_diag;
     }
+    /**
+     * @returns the k-th lower diagonal multiplied by the vector rotated by k in
+     *the diagonal method of matmul_plain, replicated over "slot_count" slots
+     *and rotated right by "shift", or an empty vector if the diagonal is zero.
+     **/
+    vector<plain_t> matmul_diagonal(size_t k, size_t slot_count,
+                                    size_t shift) const {
+        auto diag = this->get_diagonal(-static_cast<int>(k), slot_count);
+        if (std::all_of(diag.begin(), diag.end(),
+                        [](plain_t x) { return x == 0; }))
+            return {};
+
+        size_t diag_size = diag.size();
+        diag.reserve(slot_count);
+        for (size_t i = diag_size; i < slot_count; i++)
+            diag.push_back(diag[i % diag_size]);
+        rotate(diag.begin(), diag.begin() + diag.size() - shift, diag.end());
+        return diag;
+    }
     /**
      * Image Block to Columns implementation
      **/
@@ -0,0 +1,116 @@
+#include "tenseal/cpp/tensors/utils/rotation_planner.h"
+
+#include <cmath>
+
+#include "tenseal/cpp/tensors/utils/utils.h"
+
+namespace tenseal {
+
+using namespace seal;
+using namespace std;
+
+RotationPlanner::RotationPlanner(shared_ptr<TenSEALContext> ctx)
+    : _context(ctx) {
+    if (_context == nullptr) {
+        throw invalid_argument("invalid context");
+    }
+
+    switch (_context->seal_context()->key_context_data()->parms().scheme()) {
+        case scheme_type::ckks:
+            _slot_count = _context->slot_count<CKKSEncoder>();
+            break;
+        case scheme_type::bfv:
+            _slot_count = _context->slot_count<BatchEncoder>();
+            break;
+        default:
+            throw invalid_argument("unsupported scheme for rotations");
+    }
+}
+
+RotationPlanner& RotationPlanner::sum(size_t size) {
+    if (size == 0) throw invalid_argument("size must be absolutely positive");
+
+    // the vector is summed chunk by chunk
+    if (size >= _slot_count) this->add_steps(sum_vector_steps(_slot_count));
+    if (size % _slot_count != 0)
+        this->add_steps(sum_vector_steps(size % _slot_count));
+    return *this;
+}
+
+RotationPlanner& RotationPlanner::dot(size_t size) { return this->sum(size); }
+
+RotationPlanner& RotationPlanner::matmul_plain(size_t rows, size_t cols) {
+    if (rows == 0 || cols == 0)
+        throw invalid_argument("matrix shape must be absolutely positive");
+    if (rows > _slot_count)
+        throw invalid_argument(
+            "diagonal_ct_vector_matmul not supported for big vectors");
+
+    this->add_steps(matmul_plain_steps(rows));
+    return *this;
+}
+
+RotationPlanner& RotationPlanner::enc_matmul_plain(size_t plain_size,
+                                                   size_t rows_nb) {
+    if (plain_size == 0) throw invalid_argument("Plain vector can't be empty");
+    if (rows_nb == 0)
+        throw invalid_argument("rows_nb must be absolutely positive");
+
+    // same padding as enc_matmul_plain_inplace
+    size_t chunks_nb = 1 << (static_cast<size_t>(ceil(log2(plain_size))));
+    if (chunks_nb * rows_nb > _slot_count)
+        throw invalid_argument("Matrix shape doesn't match with vector size");
+
+    this->add_steps(enc_matmul_steps(chunks_nb, rows_nb));
+    return *this;
+}
+
+RotationPlanner& RotationPlanner::conv2d_im2col(size_t kernel_rows,
+                                                size_t kernel_cols,
+                                                size_t windows_nb) {
+    return this->enc_matmul_plain(kernel_rows * kernel_cols, windows_nb);
+}
+
+RotationPlanner& RotationPlanner::replicate_first_slot(size_t n) {
+    if (n == 0) throw invalid_argument("n must be absolutely positive");
+
+    switch (_context->seal_context()->key_context_data()->parms().scheme()) {
+        case scheme_type::ckks:
+            // full ciphertexts, then the remaining slots
+            if (n >= _slot_count) this->add_steps(replicate_steps(_slot_count));
+            if (n % _slot_count != 0)
+                this->add_steps(replicate_steps(n % _slot_count));
+            break;
+        default:
+            this->add_steps(replicate_steps(n));
+    }
+    return *this;
+}
+
+RotationPlanner& RotationPlanner::rotate(int step) {
+    this->add_steps({step});
+    return *this;
+}
+
+vector<int> RotationPlanner::steps() const {
+    return vector<int>(_steps.begin(), _steps.end());
+}
+
+vector<uint32_t> RotationPlanner::galois_elts() const {
+    auto galois_tool =
+        _context->seal_context()->key_context_data()->galois_tool();
+    return galois_tool->get_elts_from_steps(this->steps());
+}
+
+void RotationPlanner::generate_galois_keys() const {
+    _context->generate_galois_keys(this->steps());
+}
+
+void RotationPlanner::add_steps(const vector<int>& steps) {
+    for (int step : steps) {
+        // rotating by zero doesn't need any key
+        if (step != 0) _steps.insert(step);
+    }
+}
+
+}  // namespace tenseal
@@ -0,0 +1,81 @@
+#ifndef TENSEAL_UTILS_ROTATION_PLANNER_H
+#define TENSEAL_UTILS_ROTATION_PLANNER_H
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "tenseal/cpp/context/tensealcontext.h"
+
+namespace tenseal {
+
+using namespace seal;
+using namespace std;
+
+/**
+ * Collects the rotation steps used by a workload, in order to generate only
+ *the Galois keys it needs. The steps come from the same functions driving the
+ *vector operations, so a planned workload can't miss a key.
+ **/
+class RotationPlanner {
+   public:
+    /**
+     * @param[in] ctx: the context the workload will run on, its scheme and
+     *slot count decide how the vectors are chunked.
+     **/
+    explicit RotationPlanner(shared_ptr<TenSEALContext> ctx);
+
+    /**
+     * Plan a sum (or a dot product) over a vector of "size" elements.
+     **/
+    RotationPlanner& sum(size_t size);
+    RotationPlanner& dot(size_t size);
+    /**
+     * Plan a matmul_plain of a vector with a (rows, cols) plain matrix. The
+     *steps only depend on the number of rows.
+     **/
+    RotationPlanner& matmul_plain(size_t rows, size_t cols);
+    /**
+     * Plan an enc_matmul_plain of a plain vector of "plain_size" elements
+     *over "rows_nb" rows.
+     **/
+    RotationPlanner& enc_matmul_plain(size_t plain_size, size_t rows_nb);
+    /**
+     * Plan a conv2d_im2col with a (kernel_rows, kernel_cols) kernel over
+     *"windows_nb" windows.
+     **/
+    RotationPlanner& conv2d_im2col(size_t kernel_rows, size_t kernel_cols,
+                                   size_t windows_nb);
+    /**
+     * Plan a replicate_first_slot over "n" elements.
+     **/
+    RotationPlanner& replicate_first_slot(size_t n);
+    /**
+     * Plan a single rotation.
+     **/
+    RotationPlanner& rotate(int step);
+
+    /**
+     * @returns the planned rotation steps, sorted and without duplicates.
+     **/
+    vector<int> steps() const;
+    /**
+     * @returns the Galois elements of the planned rotation steps.
+     **/
+    vector<uint32_t> galois_elts() const;
+    /**
+     * Generate the Galois keys of the planned rotation steps in the context.
+     **/
+    void generate_galois_keys() const;
+
+   private:
+    void add_steps(const vector<int>& steps);
+
+    shared_ptr<TenSEALContext> _context;
+    size_t _slot_count;
+    set<int> _steps;
+};
+
+}  // namespace tenseal
+
+#endif
@@ -1,3 +1,4 @@
+#include <cmath>
 #include <memory>
 #include <thread>
 
@@ -21,6 +22,17 @@ inline size_t below_power2(size_t n) {
     return 1 << count;
 }
 
+/*
+Steps summing the first `bp2` slots, `bp2` being a power of two.
+*/
+inline vector<int> power2_sum_steps(size_t bp2) {
+    vector<int> steps;
+    for (size_t i = bp2 / 2; i > 0; i /= 2) {
+        steps.push_back(static_cast<int>(i));
+    }
+    return steps;
+}
+
 Ciphertext &sum_vector(shared_ptr<TenSEALContext> tenseal_context,
                        Ciphertext &vector, size_t size) {
     // Nothing to do
@@ -34,19 +46,21 @@ Ciphertext &sum_vector(shared_ptr<TenSEALContext> tenseal_context,
                     .scheme()) {
             case scheme_type::ckks: {
                 tenseal_context->evaluator->rotate_vector(
-                    encrypted, steps, galois_keys, destination);
+                    encrypted, steps, galois_keys, destination,
+                    tenseal_context->memory_pool());
                 break;
             }
             case scheme_type::bfv: {
                 tenseal_context->evaluator->rotate_rows(
-                    encrypted, steps, galois_keys, destination);
+                    encrypted, steps, galois_keys, destination,
+                    tenseal_context->memory_pool());
                 break;
             }
             default:
                 throw invalid_argument("unsupported scheme for sum_vector");
         }
     };
-    auto galois_keys = tenseal_context->galois_keys();
+    auto galois_keys = tenseal_context->galois_keys(sum_vector_steps(size));
 
     Ciphertext rest, tmp;
     size_t bp2 = below_power2(size);
@@ -56,8 +70,8 @@ Ciphertext &sum_vector(shared_ptr<TenSEALContext> tenseal_context,
         sum_vector(tenseal_context, rest, size - bp2);
     }
 
-    for (size_t i = bp2 / 2; i > 0; i /= 2) {
-        rotate(vector, i, *galois_keys, tmp);
+    for (int step : power2_sum_steps(bp2)) {
+        rotate(vector, step, *galois_keys, tmp);
         tenseal_context->evaluator->add_inplace(vector, tmp);
         tmp = vector;
     }
@@ -69,4 +83,103 @@ Ciphertext &sum_vector(shared_ptr<TenSEALContext> tenseal_context,
     return vector;
 }
 
+vector<int> sum_vector_steps(size_t size) {
+    vector<int> steps;
+    if (size == 1) return steps;
+
+    size_t bp2 = below_power2(size);
+    if (bp2 != size) {
+        steps.push_back(static_cast<int>(bp2));
+        auto rest = sum_vector_steps(size - bp2);
+        steps.insert(steps.end(), rest.begin(), rest.end());
+    }
+
+    auto power2_steps = power2_sum_steps(bp2);
+    steps.insert(steps.end(), power2_steps.begin(), power2_steps.end());
+    return steps;
+}
+
+vector<int> replicate_steps(size_t n) {
+    if (n == 0) throw invalid_argument("n must be absolutely positive.");
+
+    vector<int> steps;
+    for (size_t i = 0; i < (size_t)ceil(log2(n)); i++) {
+        steps.push_back(-(1 << i));
+    }
+    return steps;
+}
+
+vector<int> diagonal_matmul_steps(size_t size) {
+    // the first diagonal is used without rotation
+    vector<int> steps;
+    for (size_t i = 1; i < size; i++) {
+        steps.push_back(static_cast<int>(i));
+    }
+    return steps;
+}
+
+size_t bsgs_baby_steps(size_t rows) {
+    // small matrices keep the diagonal method, which skips the rotations of
+    // their zero diagonals
+    const size_t bsgs_min_rows = 16;
+    if (rows < bsgs_min_rows) return 0;
+
+    return static_cast<size_t>(ceil(sqrt(static_cast<double>(rows))));
+}
+
+vector<int> matmul_plain_steps(size_t rows) {
+    size_t baby_steps = bsgs_baby_steps(rows);
+    if (baby_steps == 0) return diagonal_matmul_steps(rows);
+
+    // the vector is rotated by the baby steps, the partial sums by the giant
+    // steps
+    vector<int> steps = diagonal_matmul_steps(baby_steps);
+    for (size_t giant = baby_steps; giant < rows; giant += baby_steps) {
+        steps.push_back(static_cast<int>(giant));
+    }
+    return steps;
+}
+
+size_t bsgs_diagonal_shift(size_t k, size_t baby_steps) {
+    return baby_steps ? k - k % baby_steps : k;
+}
+
+vector<int> enc_matmul_steps(size_t chunks_nb, size_t rows_nb) {
+    vector<int> steps;
+    while (chunks_nb > 1) {
+        chunks_nb = static_cast<int>(
+            1 << (static_cast<size_t>(ceil(log2(chunks_nb))) - 1));
+        steps.push_back(static_cast<int>(rows_nb * chunks_nb));
+    }
+    return steps;
+}
+
+namespace {
+size_t polynomial_term_depth(size_t degree, bool scaled) {
+    // the powers of two are computed by squaring, every multiplication then
+    // consumes one level
+    return polynomial_term<size_t>(
+        static_cast<int>(degree), scaled,
+        [](int power) { return static_cast<size_t>(power); },
+        [](size_t depth) { return depth + 1; },
+        [](size_t x, size_t y) { return max(x, y) + 1; });
+}
+}  // namespace
+
+size_t polyval_depth(size_t degree) {
+    size_t depth = 0;
+    for (size_t i = 1; i <= degree; i++)
+        depth = max(depth, polynomial_term_depth(i, true));
+    return depth;
+}
+
+size_t polyval_depth(const vector<double>& coefficients) {
+    size_t depth = 0;
+    for (size_t i = 1; i < coefficients.size(); i++) {
+        if (coefficients[i] == 0.0) continue;
+        depth = max(depth, polynomial_term_depth(i, coefficients[i] != 1.0));
+    }
+    return depth;
+}
+
 }  // namespace tenseal
@@ -33,27 +33,101 @@ Sum the values in the vector.
 Ciphertext& sum_vector(shared_ptr<TenSEALContext> tenseal_context,
                        Ciphertext& vector, size_t size);
 
-template <typename T>
-shared_ptr<T> compute_polynomial_term(int degree, double coeff,
-                                      const vector<shared_ptr<T>>& x_squares) {
+/*
+Rotation steps used by sum_vector() to sum the first `size` slots.
+*/
+vector<int> sum_vector_steps(size_t size);
+
+/*
+Rotation steps used to replicate the first slot over `n` slots.
+*/
+vector<int> replicate_steps(size_t n);
+
+/*
+Rotation steps used by the diagonal method to multiply a vector of `size`
+slots with a plain matrix, assuming none of its diagonals is zero.
+*/
+vector<int> diagonal_matmul_steps(size_t size);
+
+/*
+Number of baby steps of the baby-step giant-step variant of the diagonal
+method for a matrix of `rows` rows, or 0 when the diagonal method is used as
+is. It only depends on the shape of the matrix, so that the rotation steps of
+a matmul can be planned.
+*/
+size_t bsgs_baby_steps(size_t rows);
+
+/*
+Rotation steps used by matmul_plain with a matrix of `rows` rows, by the
+method chosen by bsgs_baby_steps().
+*/
+vector<int> matmul_plain_steps(size_t rows);
+
+/*
+Right rotation of the k-th diagonal given to the diagonal method, or to its
+baby-step giant-step variant with `baby_steps` baby steps, which only rotates
+it by its giant step.
+*/
+size_t bsgs_diagonal_shift(size_t k, size_t baby_steps);
+
+/*
+Rotation steps used by enc_matmul_plain to accumulate `chunks_nb` chunks of
+`rows_nb` slots, `chunks_nb` being a power of two.
+*/
+vector<int> enc_matmul_steps(size_t chunks_nb, size_t rows_nb);
+
+/*
+Builds the term `coeff * x^degree` of polyval(): x^degree is split into
+x^(2^p) * x^(degree - 2^p), the coefficient being multiplied to the last power
+of two, unless `scaled` is false (a coefficient of 1.0). `power(p)` returns
+x^(2^p), `scale(x)` multiplies x by the coefficient and `mul(x, y)` multiplies
+two terms.
+*/
+template <typename R, typename Power, typename Scale, typename Mul>
+R polynomial_term(int degree, bool scaled, const Power& power,
+                  const Scale& scale, const Mul& mul) {
     if (degree < 1) {
         throw invalid_argument("degree must be greater or equal to 1");
     }
 
     int closest_power_of_2 = static_cast<int>(floor(log2(degree)));
     int new_degree = degree - (1 << closest_power_of_2);
-    shared_ptr<T> x =
-        x_squares[closest_power_of_2]->copy();  // x^(2^closest_power_of_2)
+    R x = power(closest_power_of_2);  // x^(2^closest_power_of_2)
 
-    if (new_degree == 0 && coeff != 1.0) {
+    if (new_degree == 0) {
         // x^(2^closest_power_of_2) * coeff
-        x->mul_plain_inplace(coeff);
-    } else if (new_degree != 0) {
-        // x^(2^closest_power_of_2) * x^(new_degree) * coeff
-        x->mul_inplace(compute_polynomial_term(new_degree, coeff, x_squares));
+        return scaled ? scale(std::move(x)) : x;
     }
+    // x^(2^closest_power_of_2) * x^(new_degree) * coeff
+    R rest = polynomial_term<R>(new_degree, scaled, power, scale, mul);
+    return mul(std::move(x), std::move(rest));
+}
 
-    return x;
+/*
+Multiplicative depth consumed by polyval() for a polynomial of degree
+`degree`, whatever its coefficients.
+*/
+size_t polyval_depth(size_t degree);
+/*
+Multiplicative depth consumed by polyval() for `coefficients`, the terms with
+a coefficient of 1.0 skipping their plain multiplication.
+*/
+size_t polyval_depth(const vector<double>& coefficients);
+
+template <typename T>
+shared_ptr<T> compute_polynomial_term(int degree, double coeff,
+                                      const vector<shared_ptr<T>>& x_squares) {
+    return polynomial_term<shared_ptr<T>>(
+        degree, coeff != 1.0,
+        [&](int power) { return x_squares[power]->copy(); },
+        [&](shared_ptr<T> x) {
+            x->mul_plain_inplace(coeff);
+            return x;
+        },
+        [](shared_ptr<T> x, shared_ptr<T> y) {
+            x->mul_inplace(y);
+            return x;
+        });
 }
 
 // TODO support multi-ciphertext vectors
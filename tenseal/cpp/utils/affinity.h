@@ -0,0 +1,117 @@
+#ifndef TENSEAL_UTILS_AFFINITY_H
+#define TENSEAL_UTILS_AFFINITY_H
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace tenseal {
+namespace sync {
+
+/**
+ * Placement of the ThreadPool workers on the CPUs of the machine.
+ **/
+struct ThreadAffinity {
+    /**
+     * The CPUs the workers may run on. No pinning is done if empty.
+     **/
+    std::vector<unsigned int> cpus;
+    /**
+     * If true, every worker is pinned to a single CPU of the set, using round
+     *robin. Otherwise, every worker may run on any CPU of the set.
+     **/
+    bool pin_to_core = true;
+
+    bool empty() const { return cpus.empty(); }
+
+    /**
+     * @returns the CPUs the i-th worker should run on.
+     **/
+    std::vector<unsigned int> worker_cpus(unsigned int i) const {
+        if (cpus.empty() || !pin_to_core) return cpus;
+        return {cpus[i % cpus.size()]};
+    }
+};
+
+/**
+ * Parse a Linux CPU list, such as "0-3,8,10-11".
+ * @throws invalid_argument if the list is malformed.
+ **/
+inline std::vector<unsigned int> parse_cpu_list(const std::string& list) {
+    std::vector<unsigned int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        try {
+            auto dash = range.find('-');
+            unsigned int first = std::stoul(range.substr(0, dash));
+            unsigned int last =
+                dash == std::string::npos ? first
+                                          : std::stoul(range.substr(dash + 1));
+            if (last < first) throw std::invalid_argument(range);
+            for (unsigned int cpu = first; cpu <= last; ++cpu)
+                cpus.push_back(cpu);
+        } catch (const std::logic_error&) {
+            throw std::invalid_argument("invalid cpu list " + list);
+        }
+    }
+
+    return cpus;
+}
+
+/**
+ * @returns the CPUs of a NUMA node, read from sysfs.
+ * @throws invalid_argument if the node doesn't exist or the platform doesn't
+ *expose NUMA information.
+ **/
+inline std::vector<unsigned int> numa_node_cpus(unsigned int node) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) +
+                       "/cpulist");
+    std::string list;
+    if (!file || !std::getline(file, list))
+        throw std::invalid_argument("unknown NUMA node " +
+                                    std::to_string(node));
+
+    return parse_cpu_list(list);
+}
+
+/**
+ * @returns an affinity keeping the workers on the CPUs of a NUMA node. Memory
+ *first touched by the workers is then allocated on that node.
+ **/
+inline ThreadAffinity numa_node_affinity(unsigned int node) {
+    return ThreadAffinity{numa_node_cpus(node), /*pin_to_core=*/false};
+}
+
+/**
+ * Restrict the calling thread to a set of CPUs.
+ * @returns false if the affinity couldn't be set, or if the platform doesn't
+ *support it.
+ **/
+inline bool set_thread_affinity(const std::vector<unsigned int>& cpus) {
+    if (cpus.empty()) return false;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus)
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+}  // namespace sync
+}  // namespace tenseal
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef TENSEAL_UTILS_CANCELLATION_H
+#define TENSEAL_UTILS_CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace tenseal {
+namespace sync {
+
+/**
+ * Thrown by an operation which was stopped by its cancellation token.
+ **/
+class operation_cancelled : public std::runtime_error {
+   public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * A cancellation_token stops the operations observing it, either when
+ *cancel() is called or once its deadline is reached. Copies of a token share
+ *the same state, so a token can be cancelled from any thread.
+ * The token of the calling thread is installed with a cancellation_scope, and
+ *the parallel jobs spawned on its behalf observe it as well. The operations
+ *check it between chunks of work, so they stop within one chunk.
+ **/
+class cancellation_token {
+   public:
+    using clock = std::chrono::steady_clock;
+
+    cancellation_token() : m_state(std::make_shared<state>()) {}
+
+    /**
+     * @returns a token which cancels the operations after "timeout".
+     **/
+    template <typename Rep, typename Period>
+    static cancellation_token with_timeout(
+        std::chrono::duration<Rep, Period> timeout) {
+        cancellation_token token;
+        token.deadline(clock::now() + timeout);
+        return token;
+    }
+
+    /**
+     * Cancel the operations observing the token.
+     **/
+    void cancel() noexcept { m_state->cancelled = true; }
+
+    /**
+     * Set the time after which the token is cancelled.
+     **/
+    void deadline(clock::time_point deadline) noexcept {
+        m_state->deadline = deadline.time_since_epoch().count();
+    }
+
+    /**
+     * @returns true if the token was cancelled or its deadline passed.
+     **/
+    bool cancelled() const noexcept {
+        if (m_state->cancelled) return true;
+
+        auto deadline = m_state->deadline.load();
+        if (deadline == no_deadline) return false;
+        if (clock::now().time_since_epoch().count() < deadline) return false;
+
+        m_state->cancelled = true;
+        return true;
+    }
+
+    /**
+     * @throws operation_cancelled if the token was cancelled.
+     **/
+    void throw_if_cancelled() const {
+        if (cancelled()) throw operation_cancelled("operation cancelled");
+    }
+
+    /**
+     * @returns the token installed on the calling thread, if any.
+     **/
+    static const std::optional<cancellation_token>& current() noexcept {
+        return slot();
+    }
+
+    /**
+     * Install a token on the calling thread.
+     * @returns the previously installed token.
+     **/
+    static std::optional<cancellation_token> exchange_current(
+        std::optional<cancellation_token> token) noexcept {
+        std::swap(token, slot());
+        return token;
+    }
+
+   private:
+    static constexpr clock::rep no_deadline = clock::duration::max().count();
+
+    struct state {
+        std::atomic_bool cancelled = false;
+        std::atomic<clock::rep> deadline = no_deadline;
+    };
+    std::shared_ptr<state> m_state;
+
+    static std::optional<cancellation_token>& slot() noexcept;
+};
+
+inline std::optional<cancellation_token>& cancellation_token::slot() noexcept {
+    thread_local std::optional<cancellation_token> current;
+    return current;
+}
+
+/**
+ * Install a token on the calling thread for the lifetime of the scope.
+ **/
+class cancellation_scope {
+   public:
+    explicit cancellation_scope(std::optional<cancellation_token> token)
+        : m_previous(cancellation_token::exchange_current(std::move(token))) {}
+
+    ~cancellation_scope() {
+        cancellation_token::exchange_current(std::move(m_previous));
+    }
+
+    cancellation_scope(const cancellation_scope&) = delete;
+    cancellation_scope& operator=(const cancellation_scope&) = delete;
+
+   private:
+    std::optional<cancellation_token> m_previous;
+};
+
+/**
+ * @throws operation_cancelled if the token of the calling thread was
+ *cancelled.
+ **/
+inline void check_cancellation() {
+    auto& token = cancellation_token::current();
+    if (token) token->throw_if_cancelled();
+}
+
+}  // namespace sync
+}  // namespace tenseal
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef TENSEAL_UTILS_METRICS_H
+#define TENSEAL_UTILS_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace tenseal {
+namespace sync {
+
+/**
+ * Histogram of durations using power of two buckets: bucket 0 counts the
+ *durations under 1us, and bucket i the durations in [2^(i-1), 2^i) us. The
+ *last bucket also counts all the longer durations.
+ **/
+struct latency_histogram {
+    static constexpr std::size_t bucket_count = 32;
+    std::array<uint64_t, bucket_count> buckets{};
+
+    /**
+     * @returns the bucket counting "duration".
+     **/
+    static std::size_t bucket(std::chrono::nanoseconds duration) {
+        using std::chrono::microseconds;
+        auto us = std::chrono::duration_cast<microseconds>(duration).count();
+        std::size_t i = 0;
+        while (us > 0 && i < bucket_count - 1) {
+            us >>= 1;
+            i++;
+        }
+        return i;
+    }
+
+    /**
+     * @returns the number of recorded durations.
+     **/
+    uint64_t count() const {
+        uint64_t total = 0;
+        for (auto b : buckets) total += b;
+        return total;
+    }
+
+    /**
+     * @returns an upper bound, in microseconds, of the q-quantile of the
+     *recorded durations, q being in [0, 1].
+     **/
+    double quantile(double q) const {
+        uint64_t total = count();
+        if (total == 0) return 0;
+
+        auto rank = static_cast<uint64_t>(std::ceil(q * total));
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            seen += buckets[i];
+            if (seen >= rank && seen > 0) return std::ldexp(1.0, i);
+        }
+        return std::ldexp(1.0, bucket_count - 1);
+    }
+
+    void merge(const latency_histogram& other) {
+        for (std::size_t i = 0; i < bucket_count; ++i)
+            buckets[i] += other.buckets[i];
+    }
+};
+
+/**
+ * Counters updated by a ThreadPool worker for every task it runs.
+ **/
+class task_counters {
+   public:
+    void record(std::chrono::nanoseconds delay,
+                std::chrono::nanoseconds duration) noexcept {
+        m_tasks.fetch_add(1, std::memory_order_relaxed);
+        m_busy.fetch_add(duration.count(), std::memory_order_relaxed);
+        m_delay[latency_histogram::bucket(delay)].fetch_add(
+            1, std::memory_order_relaxed);
+        m_duration[latency_histogram::bucket(duration)].fetch_add(
+            1, std::memory_order_relaxed);
+    }
+
+    uint64_t tasks() const { return m_tasks.load(std::memory_order_relaxed); }
+
+    std::chrono::nanoseconds busy() const {
+        return std::chrono::nanoseconds(m_busy.load(std::memory_order_relaxed));
+    }
+
+    latency_histogram delay() const { return snapshot(m_delay); }
+    latency_histogram duration() const { return snapshot(m_duration); }
+
+   private:
+    using buckets = std::array<std::atomic<uint64_t>,
+                               latency_histogram::bucket_count>;
+
+    static latency_histogram snapshot(const buckets& counts) {
+        latency_histogram histogram;
+        for (std::size_t i = 0; i < counts.size(); ++i)
+            histogram.buckets[i] = counts[i].load(std::memory_order_relaxed);
+        return histogram;
+    }
+
+    std::atomic<uint64_t> m_tasks{0};
+    std::atomic<int64_t> m_busy{0};
+    buckets m_delay{};
+    buckets m_duration{};
+};
+
+/**
+ * Snapshot of the state and the activity of a ThreadPool.
+ **/
+struct ThreadPoolMetrics {
+    /**
+     * Tasks waiting in the queue of each worker, and in the shared queue.
+     **/
+    std::vector<std::size_t> queue_depth;
+    std::size_t shared_queue_depth = 0;
+    /**
+     * Tasks run by each worker. Only the workers run the tasks of the pool,
+     *helper_tasks_executed stays at zero and is kept for compatibility.
+     **/
+    std::vector<uint64_t> tasks_executed;
+    uint64_t helper_tasks_executed = 0;
+    /**
+     * Seconds each worker spent running tasks, or without any task to run,
+     *since the pool was created. A task run while waiting for a nested one
+     *counts in the busy time of both.
+     **/
+    std::vector<double> busy_time;
+    std::vector<double> idle_time;
+    /**
+     * Distribution of the running time of the tasks, and of the time they
+     *spent queued before a thread picked them.
+     **/
+    latency_histogram task_duration;
+    latency_histogram queue_delay;
+};
+
+}  // namespace sync
+}  // namespace tenseal
+
+#endif
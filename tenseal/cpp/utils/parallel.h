@@ -0,0 +1,147 @@
+#ifndef TENSEAL_UTILS_PARALLEL_H
+#define TENSEAL_UTILS_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "cancellation.h"
+#include "threadpool.h"
+
+namespace tenseal {
+namespace sync {
+
+/**
+ * Number of chunks each job should get on average, more chunks give a better
+ *balance of uneven work at the cost of more scheduling.
+ **/
+constexpr size_t chunks_per_job = 4;
+
+/**
+ * @returns the number of jobs needed to process "total" items using at most
+ *"max_jobs" jobs, with at least "grain" items per job.
+ **/
+inline size_t parallel_jobs(size_t total, size_t max_jobs, size_t grain = 1) {
+    grain = std::max<size_t>(grain, 1);
+    size_t jobs = (total + grain - 1) / grain;
+    return std::max<size_t>(std::min(jobs, max_jobs), 1);
+}
+
+/**
+ * @returns the chunk size used to split "total" items over "n_jobs" jobs.
+ **/
+inline size_t parallel_chunk(size_t total, size_t n_jobs, size_t grain = 1) {
+    size_t chunks = n_jobs * chunks_per_job;
+    size_t chunk = (total + chunks - 1) / chunks;
+    return std::max<size_t>(chunk, std::max<size_t>(grain, 1));
+}
+
+/**
+ * parallel_reduce() splits [0, total) in chunks of at least "grain" items and
+ *evaluates func(start, end) on every chunk. Chunks are claimed dynamically by
+ *at most "max_jobs" jobs, the calling thread being one of them, so uneven
+ *chunks are balanced between the workers. Each job folds the results of its
+ *chunks with reduce(acc, result), then the results of the jobs are folded
+ *into "init" on the calling thread.
+ * If any chunk fails, the remaining chunks are skipped and the first
+ *exception is rethrown once all the jobs are done. The jobs observe the
+ *cancellation token of the calling thread, which is checked before every
+ *chunk.
+ * @returns the reduced value.
+ **/
+template <typename T, typename F, typename R>
+T parallel_reduce(ThreadPool& pool, size_t total, size_t max_jobs, T init,
+                  F&& func, R&& reduce, size_t grain = 1) {
+    if (total == 0) return init;
+
+    size_t n_jobs = parallel_jobs(total, max_jobs, grain);
+    size_t chunk = parallel_chunk(total, n_jobs, grain);
+
+    std::atomic_size_t next = 0;
+    std::exception_ptr fail = nullptr;
+    std::mutex fail_mutex;
+
+    auto token = cancellation_token::current();
+
+    auto job = [&]() -> std::optional<T> {
+        cancellation_scope scope(token);
+        std::optional<T> acc;
+        while (true) {
+            size_t start = next.fetch_add(chunk);
+            if (start >= total) break;
+
+            try {
+                if (token) token->throw_if_cancelled();
+                T res = func(start, std::min(start + chunk, total));
+                if (acc)
+                    reduce(*acc, res);
+                else
+                    acc = std::move(res);
+            } catch (...) {
+                std::scoped_lock lock{fail_mutex};
+                if (!fail) fail = std::current_exception();
+                next = total;
+            }
+        }
+        return acc;
+    };
+
+    // the jobs only reference the shared one, so they're queued without any
+    // allocation
+    auto job_ref = std::ref(job);
+    static_assert(ThreadPool::inline_task<decltype(job_ref)>(),
+                  "the jobs of parallel_reduce should fit in a unique_task");
+
+    // the queued jobs reference this frame, they must all be done before it's
+    // left, including when queueing the next job fails
+    std::vector<std::future<std::optional<T>>> futures;
+    futures.reserve(n_jobs - 1);
+    try {
+        for (size_t i = 1; i < n_jobs; ++i)
+            futures.push_back(pool.enqueue_task(job_ref));
+    } catch (...) {
+        next = total;
+        for (auto& f : futures) pool.wait(f);
+        throw;
+    }
+
+    auto local = job();
+    for (auto& f : futures) pool.wait(f);
+
+    std::vector<std::optional<T>> results;
+    results.push_back(std::move(local));
+    for (auto& f : futures) results.push_back(f.get());
+
+    if (fail) std::rethrow_exception(fail);
+
+    for (auto& res : results)
+        if (res) reduce(init, *res);
+
+    return init;
+}
+
+/**
+ * parallel_for() evaluates func(start, end) over the chunks of [0, total),
+ *following the scheduling of parallel_reduce().
+ **/
+template <typename F>
+void parallel_for(ThreadPool& pool, size_t total, size_t max_jobs, F&& func,
+                  size_t grain = 1) {
+    parallel_reduce(
+        pool, total, max_jobs, true,
+        [&](size_t start, size_t end) {
+            func(start, end);
+            return true;
+        },
+        [](bool&, bool) {}, grain);
+}
+
+}  // namespace sync
+}  // namespace tenseal
+
+#endif
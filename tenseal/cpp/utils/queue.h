@@ -1,79 +1,255 @@
 #ifndef TENSEAL_UTILS_QUEUE_H
 #define TENSEAL_UTILS_QUEUE_H
 
-#include <cassert>
-#include <chrono>
-#include <condition_variable>
-#include <mutex>
-#include <queue>
-#include <type_traits>
+#include <atomic>
+#include <cstddef>
 #include <utility>
+#include <vector>
 
 namespace tenseal {
 namespace sync {
 
 /**
- * Thread-safe queue.
+ * Bounded lock-free multi-producer multi-consumer queue. The capacity is
+ *rounded up to a power of two, every slot carries a sequence number which
+ *tells the producers and the consumers whether it is free or holds an item.
  **/
 template <class T>
-class blocking_queue {
+class mpmc_queue {
    public:
+    explicit mpmc_queue(std::size_t capacity = 1024)
+        : mask_(round_up(capacity) - 1), cells_(mask_ + 1) {
+        for (std::size_t i = 0; i <= mask_; ++i)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
     /**
-     * push() appends a new item to the queue and notifies the "pop" listener
-     *about the event.
+     * try_push() appends a new item to the queue.
+     * @returns false if the queue is full.
      **/
-    template <class... Args>
-    void push(Args&&... args) {
-        {
-            std::scoped_lock lock{mutex_};
-            queue_.emplace(std::forward<Args>(args)...);
+    [[nodiscard]] bool try_push(T&& item) {
+        cell* c;
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            c = &cells_[pos & mask_];
+            std::size_t seq = c->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) -
+                        static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
         }
-        ready_.notify_one();
+
+        c->data = std::move(item);
+        c->seq.store(pos + 1, std::memory_order_release);
+        return true;
     }
     /**
-     * pop() waits until an item is available in the queue, pops it out and
-     *assigns it to the "out" parameter.
+     * try_pop() removes the oldest item and assigns it to the "out" parameter.
+     * @returns false if the queue is empty.
      **/
-    [[nodiscard]] bool pop(T& out) {
-        std::unique_lock lock{mutex_};
-        ready_.wait(lock, [this] { return !queue_.empty() || done_; });
-        if (queue_.empty()) return false;
+    [[nodiscard]] bool try_pop(T& out) {
+        cell* c;
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        while (true) {
+            c = &cells_[pos & mask_];
+            std::size_t seq = c->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) -
+                        static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+
+        out = std::move(c->data);
+        c->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+    /**
+     * @returns the number of items in the queue, which may be outdated as
+     *soon as it's returned.
+     **/
+    [[nodiscard]] std::size_t size() const noexcept {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+    /**
+     * @returns the capacity of the queue.
+     **/
+    [[nodiscard]] std::size_t capacity() const noexcept { return mask_ + 1; }
+
+   private:
+    struct cell {
+        std::atomic<std::size_t> seq;
+        T data;
+    };
+
+    static std::size_t round_up(std::size_t n) {
+        std::size_t size = 2;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    const std::size_t mask_;
+    std::vector<cell> cells_;
+    // keep the producers and the consumers on different cache lines
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::atomic<std::size_t> head_{0};
+};
+
+/**
+ * Bounded lock-free double-ended task queue owned by a single worker, after
+ *the deque of Chase and Lev, in the C11 form of Le et al. The owner pushes and
+ *pops at the back, while other workers steal the oldest items from the front,
+ *the owner only racing with the thieves on the last item.
+ * Like mpmc_queue, every slot carries a sequence number: a thief claims an
+ *item by moving the front index, then moves it out, and the owner doesn't
+ *reuse the slot before the thief released it. The items can then be any
+ *movable type, and not only pointers.
+ **/
+template <class T>
+class work_stealing_queue {
+   public:
+    explicit work_stealing_queue(std::size_t capacity = 1024)
+        : mask_(round_up(capacity) - 1), cells_(mask_ + 1) {
+        for (std::size_t i = 0; i <= mask_; ++i)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    work_stealing_queue(const work_stealing_queue&) = delete;
+    work_stealing_queue& operator=(const work_stealing_queue&) = delete;
+
+    /**
+     * try_push() appends a new item at the back of the queue, only called by
+     *the owner. The item is left untouched on failure.
+     * @returns false if the queue is full.
+     **/
+    [[nodiscard]] bool try_push(T&& item) {
+        auto bottom = bottom_.load(std::memory_order_relaxed);
+        auto top = top_.load(std::memory_order_acquire);
+        if (bottom - top > static_cast<std::ptrdiff_t>(mask_)) return false;
 
-        out = std::move(queue_.front());
-        queue_.pop();
+        // the slot may still be read by the thief which claimed its last item
+        auto& c = cells_[bottom & mask_];
+        if (c.seq.load(std::memory_order_acquire) !=
+            static_cast<std::size_t>(bottom))
+            return false;
 
+        c.data = std::move(item);
+        c.seq.store(bottom + 1, std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_release);
         return true;
     }
     /**
-     * done() notifies all listeners to shutdown.
+     * pop() removes the most recent item, only called by the owner.
+     * @returns false if the queue is empty.
      **/
-    void done() noexcept {
-        {
-            std::scoped_lock lock{mutex_};
-            done_ = true;
+    [[nodiscard]] bool pop(T& out) {
+        auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_release);
+            return false;
         }
-        ready_.notify_all();
+
+        auto& c = cells_[bottom & mask_];
+        if (top < bottom) {
+            out = std::move(c.data);
+            // the slot is reused by the next push
+            c.seq.store(bottom, std::memory_order_release);
+            return true;
+        }
+
+        // the last item, the thieves may be claiming it too
+        bool won = top_.compare_exchange_strong(top, top + 1,
+                                                std::memory_order_seq_cst,
+                                                std::memory_order_relaxed);
+        bottom_.store(bottom + 1, std::memory_order_release);
+        if (!won) return false;
+
+        out = std::move(c.data);
+        c.seq.store(bottom + mask_ + 1, std::memory_order_release);
+        return true;
     }
     /**
-     * empty() returns if the queue is empty or not.
+     * steal() removes the oldest item, called by the other workers.
+     * @returns false if the queue is empty, or if another thread took the
+     *item first.
      **/
-    [[nodiscard]] bool empty() const noexcept {
-        std::scoped_lock lock{mutex_};
-        return queue_.empty();
+    [[nodiscard]] bool steal(T& out) {
+        auto top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) return false;
+
+        if (!top_.compare_exchange_strong(top, top + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed))
+            return false;
+
+        auto& c = cells_[top & mask_];
+        // pairs with the release of the push, and of the previous thief
+        c.seq.load(std::memory_order_acquire);
+        out = std::move(c.data);
+        c.seq.store(top + mask_ + 1, std::memory_order_release);
+        return true;
     }
     /**
-     * size() returns the size of the queue.
+     * empty() returns if the queue is empty or not, which may be outdated as
+     *soon as it's returned.
+     **/
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    /**
+     * size() returns the size of the queue, which may be outdated as soon as
+     *it's returned.
      **/
-    [[nodiscard]] unsigned int size() const noexcept {
-        std::scoped_lock lock{mutex_};
-        return queue_.size();
+    [[nodiscard]] std::size_t size() const noexcept {
+        auto top = top_.load(std::memory_order_relaxed);
+        auto bottom = bottom_.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
     }
+    /**
+     * @returns the capacity of the queue.
+     **/
+    [[nodiscard]] std::size_t capacity() const noexcept { return mask_ + 1; }
 
    private:
-    std::queue<T> queue_;
-    std::condition_variable ready_;
-    std::mutex mutex_;
-    bool done_{false};
+    struct cell {
+        std::atomic<std::size_t> seq;
+        T data;
+    };
+
+    static std::size_t round_up(std::size_t n) {
+        std::size_t size = 2;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    const std::size_t mask_;
+    std::vector<cell> cells_;
+    // the indices are signed, the owner moves "bottom" below "top" while
+    // popping from an empty queue
+    alignas(64) std::atomic<std::ptrdiff_t> top_{0};
+    alignas(64) std::atomic<std::ptrdiff_t> bottom_{0};
 };
 
 }  // namespace sync
@@ -20,6 +20,23 @@ std::string SEALSerialize(const T& sealobj) {
     return stream.str();
 }
 
+/**
+ * Saves a seeded SEAL object to a string, then loads its expanded form into
+ *"destination".
+ * Compatible SEAL types: Ciphertext, GaloisKeys, RelinKeys.
+ * @returns the seeded serialization.
+ **/
+template <class T>
+std::string SEALSerializeSeeded(
+    const SEALContext& sealctx, const Serializable<T>& seeded, T& destination,
+    compr_mode_type compr_mode = Serialization::compr_mode_default) {
+    std::stringstream stream;
+    seeded.save(stream, compr_mode);
+    destination.load(sealctx, stream);
+
+    return stream.str();
+}
+
 /**
  * Loads a SEAL object from a string.
  * Compatible SEAL types: Ciphertext, Plaintext, SecretKey, PublicKey,
@@ -36,6 +53,22 @@ T SEALDeserialize(const SEALContext& sealctx, const string& in) {
     return out;
 }
 
+/**
+ * Loads a SEAL object from a string, allocating it from a memory pool.
+ * Compatible SEAL types: Ciphertext, Plaintext.
+ **/
+template <class T>
+T SEALDeserialize(const SEALContext& sealctx, const string& in,
+                  MemoryPoolHandle pool) {
+    T out(pool);
+
+    std::stringstream stream;
+    stream << in;
+    out.load(sealctx, stream);
+
+    return out;
+}
+
 /**
  * Loads a SEAL object from a string.
  * Compatible SEAL types: EncryptionParameters, Modulus, BigUInt, IntArray
@@ -0,0 +1,115 @@
+#ifndef TENSEAL_UTILS_TASK_H
+#define TENSEAL_UTILS_TASK_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tenseal {
+namespace sync {
+
+/**
+ * Move-only wrapper for a callable with no arguments and no result.
+ * Callables which fit in the inline buffer are stored without any allocation,
+ *bigger ones are moved to the heap.
+ **/
+class unique_task {
+   public:
+    static constexpr std::size_t inline_size = 64;
+
+    unique_task() noexcept = default;
+
+    template <typename F,
+              typename = std::enable_if_t<
+                  !std::is_same_v<std::decay_t<F>, unique_task>>>
+    unique_task(F&& f) {
+        using T = std::decay_t<F>;
+        if constexpr (fits_inline<T>()) {
+            new (&m_storage) T(std::forward<F>(f));
+            m_ops = &inline_ops<T>;
+        } else {
+            *reinterpret_cast<T**>(&m_storage) = new T(std::forward<F>(f));
+            m_ops = &heap_ops<T>;
+        }
+    }
+
+    unique_task(unique_task&& other) noexcept { move_from(other); }
+
+    unique_task& operator=(unique_task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    unique_task(const unique_task&) = delete;
+    unique_task& operator=(const unique_task&) = delete;
+
+    ~unique_task() { reset(); }
+
+    /**
+     * Run the wrapped callable.
+     **/
+    void operator()() { m_ops->invoke(&m_storage); }
+
+    explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+    /**
+     * @returns whether a callable of type T is stored in the inline buffer.
+     **/
+    template <typename T>
+    static constexpr bool fits_inline() {
+        return sizeof(T) <= inline_size &&
+               alignof(T) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<T>;
+    }
+
+   private:
+    struct ops {
+        void (*invoke)(void*);
+        void (*move)(void* from, void* to) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    template <typename T>
+    static constexpr ops inline_ops = {
+        [](void* s) { (*static_cast<T*>(s))(); },
+        [](void* from, void* to) noexcept {
+            new (to) T(std::move(*static_cast<T*>(from)));
+            static_cast<T*>(from)->~T();
+        },
+        [](void* s) noexcept { static_cast<T*>(s)->~T(); },
+    };
+
+    template <typename T>
+    static constexpr ops heap_ops = {
+        [](void* s) { (**static_cast<T**>(s))(); },
+        [](void* from, void* to) noexcept {
+            *static_cast<T**>(to) = *static_cast<T**>(from);
+        },
+        [](void* s) noexcept { delete *static_cast<T**>(s); },
+    };
+
+    void move_from(unique_task& other) noexcept {
+        if (!other.m_ops) return;
+        other.m_ops->move(&other.m_storage, &m_storage);
+        m_ops = other.m_ops;
+        other.m_ops = nullptr;
+    }
+
+    void reset() noexcept {
+        if (!m_ops) return;
+        m_ops->destroy(&m_storage);
+        m_ops = nullptr;
+    }
+
+    std::aligned_storage_t<inline_size, alignof(std::max_align_t)> m_storage;
+    const ops* m_ops = nullptr;
+};
+
+}  // namespace sync
+}  // namespace tenseal
+
+#endif
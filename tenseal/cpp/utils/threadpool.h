@@ -1,21 +1,31 @@
 #ifndef TENSEAL_UTILS_THREADPOOL_H
 #define TENSEAL_UTILS_THREADPOOL_H
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
+#include "affinity.h"
+#include "metrics.h"
 #include "queue.h"
+#include "task.h"
+#include "seal/memorymanager.h"
 
 namespace tenseal {
 
 /* Compute how many threads can run in parallel */
 inline size_t get_concurrency() {
-    size_t concurrency = thread::hardware_concurrency();
+    size_t concurrency = std::thread::hardware_concurrency();
 
     if (concurrency != 0) return concurrency;
 
@@ -26,35 +36,46 @@ namespace sync {
 
 /**
  * A ThreadPool class for managing and dispatching tasks to a number of threads.
+ * Every worker owns a task queue, and idle workers steal tasks from the
+ *queues of the busy ones, so a single slow task doesn't hold back the work
+ *queued behind it.
  **/
 class ThreadPool {
    public:
     /**
      * Create "n_threads" workers, each with a dedicated task queue, and execute
      * the task as they arrive in the queues.
+     * The workers are pinned to the CPUs of "affinity", if any.
      **/
-    ThreadPool(unsigned int n_threads = get_concurrency())
-        : m_queues(n_threads), m_count(n_threads) {
+    ThreadPool(unsigned int n_threads = get_concurrency(),
+               ThreadAffinity affinity = {})
+        : m_queues(n_threads),
+          m_counters(new task_counters[n_threads + 1]()),
+          m_count(n_threads),
+          m_affinity(affinity),
+          m_started(clock::now()) {
         assert(n_threads != 0);
-        auto worker = [&](unsigned int i) {
-            while (true) {
-                Proc f;
-                if (!m_queues[i].pop(f)) break;
-                f();
-            }
-        };
         for (unsigned int i = 0; i < n_threads; ++i)
-            m_workers.emplace_back(worker, i);
+            m_memory_pools.push_back(seal::MemoryPoolHandle::New());
+        for (unsigned int i = 0; i < n_threads; ++i)
+            m_workers.emplace_back([this, i]() { this->worker_loop(i); });
     }
 
     ~ThreadPool() noexcept {
-        for (auto& queue : m_queues) queue.done();
+        {
+            std::scoped_lock lock{m_mutex};
+            m_done = true;
+        }
+        m_ready.notify_all();
         for (auto& worker : m_workers) worker.join();
     }
 
     /**
-     * enqueue_task() assigns tasks to worker queues using round robin
-     *scheduling.
+     * enqueue_task() pushes the task to the queue of the calling worker, if
+     *called from one of the pool's workers, or to the shared lock-free queue
+     *otherwise. When the queue of the worker is full, the task goes to the
+     *shared queue, and when the shared queue is full, the workers run pending
+     *tasks and the other threads wait until it has room.
      * @returns a std::future object with the result of the task.
      **/
     template <typename F, typename... Args>
@@ -62,28 +83,281 @@ class ThreadPool {
         -> std::future<typename std::result_of<F(Args...)>::type> {
         using return_type = typename std::result_of<F(Args...)>::type;
 
-        auto task = std::make_shared<std::packaged_task<return_type()>>(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-        std::future<return_type> res = task->get_future();
-        auto work = [task]() { (*task)(); };
+        if constexpr (sizeof...(Args) == 0) {
+            return this->submit<return_type>(std::forward<F>(f));
+        } else {
+            return this->submit<return_type>(
+                [f = std::forward<F>(f),
+                 args = std::make_tuple(
+                     std::forward<Args>(args)...)]() mutable {
+                    return std::apply(f, std::move(args));
+                });
+        }
+    }
 
-        unsigned int i = m_index++;
-        m_queues[i % m_count].push(work);
+    /**
+     * @returns whether the tasks running "F" are queued without any
+     *allocation, their closure fitting in the inline buffer of unique_task.
+     **/
+    template <typename F>
+    static constexpr bool inline_task() {
+        using return_type = typename std::result_of<F()>::type;
+        return unique_task::fits_inline<pool_task<return_type, F>>();
+    }
 
-        return res;
+    /**
+     * wait() blocks until the future is ready. Called from one of the pool's
+     *workers, it executes pending tasks in the meantime, so nested parallel
+     *jobs neither deadlock nor serialize the pool. The other threads only
+     *block: running an unrelated task, possibly a long one queued by another
+     *caller, would delay their own result.
+     **/
+    template <typename T>
+    void wait(const std::future<T>& res) {
+        if (t_pool != this) {
+            res.wait();
+            return;
+        }
+
+        while (res.wait_for(std::chrono::seconds(0)) !=
+               std::future_status::ready) {
+            if (!run_pending_task())
+                res.wait_for(std::chrono::microseconds(50));
+        }
+    }
+
+    /**
+     * run_pending_task() executes one pending task on the calling worker,
+     *starting with the most recent task of its own queue, usually a child of
+     *the task it is running.
+     * @returns false if there was no task to run, or if the calling thread
+     *isn't one of the pool's workers.
+     **/
+    bool run_pending_task() {
+        Proc f;
+        if (t_pool != this || !try_pop(t_index, f)) return false;
+
+        m_pending--;
+        f();
+        return true;
+    }
+
+    /**
+     * @returns the number of workers.
+     **/
+    unsigned int size() const { return m_count; }
+
+    /**
+     * @returns the placement of the workers.
+     **/
+    const ThreadAffinity& affinity() const { return m_affinity; }
+
+    /**
+     * memory_pool() returns the SEAL memory pool owned by the calling worker,
+     *or the global SEAL memory pool if called from outside of a ThreadPool.
+     *Using it for the allocations made by the tasks avoids the contention
+     *of all the workers on the global pool.
+     **/
+    static seal::MemoryPoolHandle memory_pool() {
+        if (t_pool) return t_pool->m_memory_pools[t_index];
+        return seal::MemoryManager::GetPool();
+    }
+
+    /**
+     * @returns the number of bytes allocated by the memory pool of each
+     *worker.
+     **/
+    std::vector<std::size_t> memory_usage() const {
+        std::vector<std::size_t> usage;
+        for (auto& pool : m_memory_pools)
+            usage.push_back(pool.alloc_byte_count());
+        return usage;
+    }
+
+    /**
+     * @returns a snapshot of the queues and of the activity of the workers.
+     **/
+    ThreadPoolMetrics metrics() const {
+        ThreadPoolMetrics metrics;
+        auto elapsed = std::chrono::duration<double>(clock::now() - m_started);
+
+        metrics.shared_queue_depth = m_injector.size();
+        for (unsigned int i = 0; i <= m_count; ++i) {
+            auto& counters = m_counters[i];
+            metrics.task_duration.merge(counters.duration());
+            metrics.queue_delay.merge(counters.delay());
+            if (i == m_count) {
+                metrics.helper_tasks_executed = counters.tasks();
+                break;
+            }
+
+            double busy =
+                std::chrono::duration<double>(counters.busy()).count();
+            metrics.queue_depth.push_back(m_queues[i].size());
+            metrics.tasks_executed.push_back(counters.tasks());
+            metrics.busy_time.push_back(busy);
+            metrics.idle_time.push_back(std::max(elapsed.count() - busy, 0.0));
+        }
+
+        return metrics;
     }
 
    private:
-    using Proc = std::function<void(void)>;
+    using Proc = unique_task;
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * Closure of a queued task, which publishes the result of "f" to the
+     *future returned by enqueue_task(). It is kept small, so the common tasks
+     *fit in the inline buffer of unique_task.
+     **/
+    template <typename R, typename F>
+    struct pool_task {
+        ThreadPool* pool;
+        clock::time_point enqueued;
+        std::promise<R> promise;
+        F f;
+
+        void operator()() {
+            auto start = clock::now();
+            // record the task before publishing its result, so the metrics
+            // account for every task the caller saw completing
+            try {
+                if constexpr (std::is_void_v<R>) {
+                    f();
+                    pool->record_task(enqueued, start);
+                    promise.set_value();
+                } else {
+                    auto value = f();
+                    pool->record_task(enqueued, start);
+                    promise.set_value(std::move(value));
+                }
+            } catch (...) {
+                pool->record_task(enqueued, start);
+                promise.set_exception(std::current_exception());
+            }
+        }
+    };
+
+    template <typename R, typename F>
+    std::future<R> submit(F&& f) {
+        std::promise<R> promise;
+        std::future<R> res = promise.get_future();
+        Proc work = pool_task<R, std::decay_t<F>>{
+            this, clock::now(), std::move(promise), std::forward<F>(f)};
+
+        m_pending++;
+        if (t_pool != this || !m_queues[t_index].try_push(std::move(work))) {
+            while (!m_injector.try_push(std::move(work)))
+                if (t_pool != this || !run_pending_task())
+                    std::this_thread::yield();
+        }
+
+        // Only parked workers need the lock and the notification. The
+        // increment of m_pending above is ordered before the read of
+        // m_sleeping, and a parking worker increments m_sleeping before
+        // checking m_pending, so one of them always sees the other.
+        if (m_sleeping > 0) {
+            { std::scoped_lock lock{m_mutex}; }
+            m_ready.notify_one();
+        }
+
+        return res;
+    }
+
+    /**
+     * Account a task on the counters of the calling worker, or on the
+     *counters shared by the threads outside of the pool.
+     **/
+    void record_task(clock::time_point enqueued,
+                     clock::time_point start) noexcept {
+        unsigned int slot = t_pool == this ? t_index : m_count;
+        m_counters[slot].record(start - enqueued, clock::now() - start);
+    }
+
+    /**
+     * Number of attempts to find a task before a worker parks.
+     **/
+    static constexpr unsigned int spin_count = 64;
+
+    /**
+     * Pop a task from the worker's own queue, or steal one from the other
+     *workers, starting with the next one.
+     **/
+    bool try_pop(unsigned int i, Proc& f) {
+        if (m_queues[i].pop(f)) return true;
+
+        return try_steal(i + 1, f);
+    }
+
+    /**
+     * Take a task from the shared queue, or steal the oldest task from any
+     *worker queue, starting with the i-th one.
+     **/
+    bool try_steal(unsigned int i, Proc& f) {
+        if (m_injector.try_pop(f)) return true;
+
+        for (unsigned int k = 0; k < m_count; ++k)
+            if (m_queues[(i + k) % m_count].steal(f)) return true;
+
+        return false;
+    }
+
+    void worker_loop(unsigned int i) {
+        t_pool = this;
+        t_index = i;
+        set_thread_affinity(m_affinity.worker_cpus(i));
+
+        unsigned int spins = 0;
+        while (true) {
+            Proc f;
+            if (try_pop(i, f)) {
+                m_pending--;
+                f();
+                spins = 0;
+                continue;
+            }
+
+            // spin for a while before parking, tasks often come in bursts
+            if (++spins < spin_count && !m_done) {
+                std::this_thread::yield();
+                continue;
+            }
+            spins = 0;
+
+            std::unique_lock lock{m_mutex};
+            m_sleeping++;
+            m_ready.wait(lock, [this] { return m_done || m_pending > 0; });
+            m_sleeping--;
+            if (m_done && m_pending == 0) break;
+        }
+    }
 
-    using Queues = std::vector<blocking_queue<Proc>>;
+    using Queues = std::vector<work_stealing_queue<Proc>>;
     Queues m_queues;
+    mpmc_queue<Proc> m_injector;
 
     using Threads = std::vector<std::thread>;
     Threads m_workers;
 
+    std::vector<seal::MemoryPoolHandle> m_memory_pools;
+    std::unique_ptr<task_counters[]> m_counters;
+
     const unsigned int m_count;
-    std::atomic_uint m_index = 0;
+    const ThreadAffinity m_affinity;
+    const clock::time_point m_started;
+    std::atomic_uint m_pending = 0;
+    std::atomic_uint m_sleeping = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::atomic_bool m_done = false;
+
+    /**
+     * Identity of the current thread, if it is one of the pool's workers.
+     **/
+    inline static thread_local ThreadPool* t_pool = nullptr;
+    inline static thread_local unsigned int t_index = 0;
 };
 
 }  // namespace sync
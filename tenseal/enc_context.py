@@ -180,6 +180,83 @@ class Context:
             return cls._wrap(ts._ts_cpp.TenSEALContext.deserialize(data, n_threads))
         return cls._wrap(ts._ts_cpp.TenSEALContext.deserialize(data))
 
+    @staticmethod
+    def use_shared_dispatcher(status: bool = True):
+        """Make the contexts share a single process-wide threadpool instead of creating
+        one each. Every context still dispatches at most n_threads parallel jobs.
+
+        Args:
+            status: on/off.
+        """
+        ts._ts_cpp.TenSEALContext.use_shared_dispatcher(status)
+
+    @staticmethod
+    def use_context_registry(status: bool = True):
+        """Make the contexts created or deserialized afterwards share the SEALContext and
+        the public keys already built for identical parameters and key buffers. This
+        avoids recomputing the NTT tables when the same context is loaded again and again.
+
+        Args:
+            status: on/off.
+        """
+        ts._ts_cpp.TenSEALContext.use_context_registry(status)
+
+    @staticmethod
+    def clear_context_registry():
+        """Release the SEALContexts and keys kept for the next contexts."""
+        ts._ts_cpp.TenSEALContext.clear_context_registry()
+
+    @staticmethod
+    def context_registry_capacity(capacity: int = None) -> int:
+        """Get or set the number of recently used SEALContexts and keys the registry
+        keeps alive once the contexts using them are released.
+
+        Args:
+            capacity: the new capacity, the current one is returned if None.
+        """
+        if capacity is not None:
+            ts._ts_cpp.TenSEALContext.context_registry_capacity(capacity)
+        return ts._ts_cpp.TenSEALContext.context_registry_capacity()
+
+    def fingerprint(self) -> str:
+        """Hex digest of the parameters, encryption type, scale, flags and keys of the
+        context. Identical contexts have the same fingerprint."""
+        return "".join(f"{word:016x}" for word in self.data.fingerprint())
+
+    def pin_dispatcher(
+        self, cpus: List[int] = None, numa_node: int = None, pin_to_core: bool = True
+    ):
+        """Pin the threads running the parallel computation of this context to a set of
+        CPUs, or to the CPUs of a NUMA node. Ciphertexts encrypted or loaded by these
+        threads are then allocated on the same node.
+
+        Args:
+            cpus: list of CPU ids.
+            numa_node: id of a NUMA node, used if cpus isn't set.
+            pin_to_core: pin every thread to a single CPU of the list.
+        """
+        if cpus is not None:
+            self.data.dispatcher_cpus(cpus, pin_to_core)
+        elif numa_node is not None:
+            self.data.dispatcher_numa_node(numa_node)
+        else:
+            raise ValueError("either cpus or numa_node must be set")
+
+    def dispatcher_metrics(self) -> "ts._ts_cpp.ThreadPoolMetrics":
+        """Get the queue depths, the number of tasks executed, the busy and idle time of
+        every thread running the parallel computation of this context, along with
+        histograms of the task durations and of the time tasks spent queued."""
+        return self.data.dispatcher_metrics()
+
+    def encode_cache_stats(self) -> "ts._ts_cpp.EncodeCacheStats":
+        """Get the number of hits and misses of the encode cache, along with its size and
+        capacity."""
+        return self.data.encode_cache_stats()
+
+    def clear_encode_cache(self):
+        """Release the plaintexts of the encode cache and reset its counters."""
+        self.data.clear_encode_cache()
+
     def serialize(
         self,
         save_public_key: bool = True,
@@ -229,20 +306,81 @@ class Context:
     def auto_rescale(self, value: bool):
         self.data.auto_rescale = value
 
+    @property
+    def lazy_galois_keys(self) -> bool:
+        """Whether the Galois key of a rotation step is only generated the first time an
+        operation rotates by it. This requires the context to hold the secret key."""
+        return self.data.lazy_galois_keys
+
+    @lazy_galois_keys.setter
+    def lazy_galois_keys(self, value: bool):
+        self.data.lazy_galois_keys = value
+
+    @property
+    def encode_cache_capacity(self) -> int:
+        """The number of plain operands kept encoded by the context, so that multiplying
+        by the same values again, e.g. by the weights of a model, skips their encoding.
+        The cache is disabled when set to 0, the default."""
+        return self.data.encode_cache_capacity
+
+    @encode_cache_capacity.setter
+    def encode_cache_capacity(self, value: int):
+        self.data.encode_cache_capacity = value
+
+    @property
+    def resident_galois_keys(self) -> int:
+        """The number of Galois keys kept in memory once loaded from a key store, the
+        least recently loaded ones being released first. Defaults to 32."""
+        return self.data.resident_galois_keys
+
+    @resident_galois_keys.setter
+    def resident_galois_keys(self, value: int):
+        self.data.resident_galois_keys = value
+
     def has_galois_keys(self) -> bool:
         return self.data.has_galois_keys()
 
     def galois_keys(self) -> GaloisKeys:
         return GaloisKeys(self.data.galois_keys())
 
-    def generate_galois_keys(self, secret_key: SecretKey = None):
-        if secret_key is None:
-            self.data.generate_galois_keys()
-        elif isinstance(secret_key, SecretKey):
-            self.data.generate_galois_keys(secret_key.data)
-        else:
+    def generate_galois_keys(self, secret_key: SecretKey = None, steps: List[int] = None):
+        """Generate the Galois keys needed for rotations.
+
+        Args:
+            secret_key: the secret key to use, the one of the context if None.
+            steps: rotation steps to generate keys for. If None, keys are generated for
+                all the power of two steps, which is much bigger.
+        """
+        if secret_key is not None and not isinstance(secret_key, SecretKey):
             raise TypeError(f"incorrect type: {type(secret_key)} != SecretKey")
 
+        if steps is None:
+            if secret_key is None:
+                self.data.generate_galois_keys()
+            else:
+                self.data.generate_galois_keys(secret_key.data)
+        elif secret_key is None:
+            self.data.generate_galois_keys(list(steps))
+        else:
+            self.data.generate_galois_keys(secret_key.data, list(steps))
+
+    def store_galois_keys(self, path: str):
+        """Move the Galois keys to a key store file. The keys are released from memory,
+        then an operation only loads the keys of the rotation steps it uses.
+
+        Args:
+            path: the file to write, it must not be mapped by another context.
+        """
+        self.data.store_galois_keys(path)
+
+    def load_galois_keys(self, path: str):
+        """Use the Galois keys of a key store file written by store_galois_keys.
+
+        Args:
+            path: the key store file.
+        """
+        self.data.load_galois_keys(path)
+
     def has_relin_keys(self) -> bool:
         return self.data.has_relin_keys()
 
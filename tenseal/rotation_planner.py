@@ -0,0 +1,65 @@
+"""Planning of the rotation steps, and Galois keys, needed by a workload."""
+from typing import List
+import tenseal as ts
+
+
+class RotationPlanner:
+    def __init__(self, context: "ts.Context"):
+        """Collect the rotation steps used by the planned operations, in order to
+        generate only the Galois keys they need instead of all the power of two
+        steps. The steps are computed by the same code running the operations.
+
+        Args:
+            context: the context the operations will run on.
+        """
+        if not isinstance(context, ts.Context):
+            raise TypeError(f"incorrect type: {type(context)} != Context")
+        self._context = context
+        self.data = ts._ts_cpp.RotationPlanner(context.data)
+
+    def sum(self, size: int) -> "RotationPlanner":
+        """Plan a sum over a vector of `size` elements."""
+        self.data.sum(size)
+        return self
+
+    def dot(self, size: int) -> "RotationPlanner":
+        """Plan a dot product between vectors of `size` elements."""
+        self.data.dot(size)
+        return self
+
+    def matmul_plain(self, rows: int, cols: int) -> "RotationPlanner":
+        """Plan a vector-matrix product with a (rows, cols) plain matrix."""
+        self.data.matmul_plain(rows, cols)
+        return self
+
+    def enc_matmul_plain(self, plain_size: int, rows_nb: int) -> "RotationPlanner":
+        """Plan an enc_matmul_plain with a plain vector of `plain_size` elements."""
+        self.data.enc_matmul_plain(plain_size, rows_nb)
+        return self
+
+    def conv2d_im2col(
+        self, kernel_rows: int, kernel_cols: int, windows_nb: int
+    ) -> "RotationPlanner":
+        """Plan a conv2d_im2col with a (kernel_rows, kernel_cols) kernel."""
+        self.data.conv2d_im2col(kernel_rows, kernel_cols, windows_nb)
+        return self
+
+    def replicate_first_slot(self, n: int) -> "RotationPlanner":
+        """Plan a replicate_first_slot over `n` elements."""
+        self.data.replicate_first_slot(n)
+        return self
+
+    def rotate(self, step: int) -> "RotationPlanner":
+        """Plan a single rotation."""
+        self.data.rotate(step)
+        return self
+
+    def steps(self) -> List[int]:
+        return self.data.steps()
+
+    def galois_elts(self) -> List[int]:
+        return self.data.galois_elts()
+
+    def generate_galois_keys(self):
+        """Generate the Galois keys of the planned steps in the context."""
+        self.data.generate_galois_keys()
@@ -4,6 +4,22 @@ import tenseal as ts
 from abc import ABC
 
 
+class TensorFuture:
+    """Handle on the result of an asynchronous tensor operation"""
+
+    def __init__(self, cls, future):
+        self._cls = cls
+        self._future = future
+
+    def done(self) -> bool:
+        """Check whether the operation has completed"""
+        return self._future.done()
+
+    def result(self) -> "AbstractTensor":
+        """Wait for the operation to complete and return the resulting tensor"""
+        return self._cls._wrap(self._future.result())
+
+
 class AbstractTensor(ABC):
     @property
     def data(self):
@@ -179,3 +195,24 @@ class AbstractTensor(ABC):
     def polyval_(self, coefficients: Union[List[float], List[int]]) -> "AbstractTensor":
         self.data.polyval_(coefficients)
         return self
+
+    def _future(self, future) -> TensorFuture:
+        return TensorFuture(type(self), future)
+
+    # The *_async operations run on the dispatcher of the context and return a
+    # TensorFuture. The encrypted operands must not be modified in place until
+    # the result is ready.
+    def neg_async(self) -> TensorFuture:
+        return self._future(self.data.neg_async())
+
+    def sum_async(self, axis=0) -> TensorFuture:
+        return self._future(self.data.sum_async(axis))
+
+    def square_async(self) -> TensorFuture:
+        return self._future(self.data.square_async())
+
+    def pow_async(self, power) -> TensorFuture:
+        return self._future(self.data.pow_async(power))
+
+    def polyval_async(self, coefficients: Union[List[float], List[int]]) -> TensorFuture:
+        return self._future(self.data.polyval_async(coefficients))
@@ -3,7 +3,7 @@
 
 from typing import List
 import tenseal as ts
-from tenseal.tensors.abstract_tensor import AbstractTensor
+from tenseal.tensors.abstract_tensor import AbstractTensor, TensorFuture
 
 
 class BFVTensor(AbstractTensor):
@@ -77,6 +77,18 @@ class BFVTensor(AbstractTensor):
         self.data -= other
         return self
 
+    def add_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="int")
+        return self._future(self.data.add_async(other))
+
+    def mul_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="int")
+        return self._future(self.data.mul_async(other))
+
+    def sub_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="int")
+        return self._future(self.data.sub_async(other))
+
     def dot(self, other) -> "BFVTensor":
         other = self._get_operand(other, dtype="int")
         result = self.data.dot(other)
@@ -87,6 +99,10 @@ class BFVTensor(AbstractTensor):
         self.data.dot_(other)
         return self
 
+    def dot_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="int")
+        return self._future(self.data.dot_async(other))
+
     def mm(self, other) -> "BFVTensor":
         other = self._get_operand(other, dtype="int")
         result = self.data.mm(other)
@@ -97,6 +113,10 @@ class BFVTensor(AbstractTensor):
         self.data.mm_(other)
         return self
 
+    def mm_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="int")
+        return self._future(self.data.mm_async(other))
+
     def __matmul__(self, other) -> "BFVTensor":
         return self.mm(other)
 
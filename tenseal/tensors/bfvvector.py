@@ -2,7 +2,7 @@
 """
 from typing import List
 import tenseal as ts
-from tenseal.tensors.abstract_tensor import AbstractTensor
+from tenseal.tensors.abstract_tensor import AbstractTensor, TensorFuture
 
 
 class BFVVector(AbstractTensor):
@@ -102,6 +102,18 @@ class BFVVector(AbstractTensor):
         self.data -= other
         return self
 
+    def add_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="int")
+        return self._future(self.data.add_async(other))
+
+    def mul_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="int")
+        return self._future(self.data.mul_async(other))
+
+    def sub_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="int")
+        return self._future(self.data.sub_async(other))
+
     @classmethod
     def _dot(cls, other):
         if isinstance(other, (cls)):
@@ -123,3 +135,7 @@ class BFVVector(AbstractTensor):
         other = self._dot(other)
         self.data.dot_(other)
         return self
+
+    def dot_async(self, other) -> TensorFuture:
+        other = self._dot(other)
+        return self._future(self.data.dot_async(other))
@@ -3,7 +3,7 @@
 
 from typing import List
 import tenseal as ts
-from tenseal.tensors.abstract_tensor import AbstractTensor
+from tenseal.tensors.abstract_tensor import AbstractTensor, TensorFuture
 
 
 class CKKSTensor(AbstractTensor):
@@ -103,6 +103,18 @@ class CKKSTensor(AbstractTensor):
         self.data -= other
         return self
 
+    def add_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="float")
+        return self._future(self.data.add_async(other))
+
+    def mul_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="float")
+        return self._future(self.data.mul_async(other))
+
+    def sub_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="float")
+        return self._future(self.data.sub_async(other))
+
     def dot(self, other) -> "CKKSTensor":
         other = self._get_operand(other, dtype="float")
         result = self.data.dot(other)
@@ -113,6 +125,10 @@ class CKKSTensor(AbstractTensor):
         self.data.dot_(other)
         return self
 
+    def dot_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="float")
+        return self._future(self.data.dot_async(other))
+
     def mm(self, other) -> "CKKSTensor":
         other = self._get_operand(other, dtype="float")
         result = self.data.mm(other)
@@ -123,6 +139,10 @@ class CKKSTensor(AbstractTensor):
         self.data.mm_(other)
         return self
 
+    def mm_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="float")
+        return self._future(self.data.mm_async(other))
+
     def __matmul__(self, other) -> "CKKSTensor":
         return self.mm(other)
 
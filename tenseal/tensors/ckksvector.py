@@ -1,8 +1,9 @@
 """Vector of values encrypted using CKKS. Less flexible, but more efficient than CKKSTensor.
 """
 from typing import List
+import numpy as np
 import tenseal as ts
-from tenseal.tensors.abstract_tensor import AbstractTensor
+from tenseal.tensors.abstract_tensor import AbstractTensor, TensorFuture
 
 
 class CKKSVector(AbstractTensor):
@@ -32,6 +33,12 @@ class CKKSVector(AbstractTensor):
         else:
             if not isinstance(context, ts.Context):
                 raise TypeError("context must be a tenseal.Context")
+            # NumPy arrays are encrypted from their buffer, without a copy
+            if isinstance(vector, np.ndarray):
+                if vector.ndim != 1:
+                    raise ValueError("can only encrypt a vector")
+                self.data = ts._ts_cpp.CKKSVector(context.data, vector, scale)
+                return
             if not isinstance(vector, ts.PlainTensor):
                 vector = ts.plain_tensor(vector, dtype="float")
             if len(vector.shape) != 1:
@@ -117,6 +124,18 @@ class CKKSVector(AbstractTensor):
         self.data -= other
         return self
 
+    def add_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="float")
+        return self._future(self.data.add_async(other))
+
+    def mul_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="float")
+        return self._future(self.data.mul_async(other))
+
+    def sub_async(self, other) -> TensorFuture:
+        other = self._get_operand(other, dtype="float")
+        return self._future(self.data.sub_async(other))
+
     @classmethod
     def _dot(cls, other):
         if isinstance(other, (cls)):
@@ -139,8 +158,14 @@ class CKKSVector(AbstractTensor):
         self.data.dot_(other)
         return self
 
+    def dot_async(self, other) -> TensorFuture:
+        other = self._dot(other)
+        return self._future(self.data.dot_async(other))
+
     @classmethod
     def _mm(cls, other):
+        if isinstance(other, ts.EncodedMatrix):
+            return other.data
         if not isinstance(other, ts.PlainTensor):
             try:
                 other = ts.plain_tensor(other, dtype="float")
@@ -159,6 +184,10 @@ class CKKSVector(AbstractTensor):
         self.data.mm_(other)
         return self
 
+    def mm_async(self, other) -> TensorFuture:
+        other = self._mm(other)
+        return self._future(self.data.mm_async(other))
+
     def matmul(self, *args, **kwargs) -> "CKKSVector":
         return self.mm(*args, **kwargs)
 
@@ -0,0 +1,62 @@
+"""Plain matrix encoded once for the vector-matrix multiplications of CKKSVector.
+"""
+from typing import List
+import tenseal as ts
+
+
+class EncodedMatrix:
+    def __init__(
+        self,
+        context: "ts.Context" = None,
+        matrix=None,
+        scale: float = None,
+        data: ts._ts_cpp.EncodedMatrix = None,
+    ):
+        """Constructor method for the EncodedMatrix object, which encodes the diagonals
+        of a plain matrix once so that every CKKSVector.mm with it skips the encoding.
+
+        Args:
+            context: a Context object, holding the encryption parameters and keys.
+            matrix: a matrix of float numbers, with as many rows as the vectors it multiplies.
+            scale: the scale to be used to encode the matrix. The global_scale provided by the context is used if it's set to None.
+            data: A ts._ts_cpp.EncodedMatrix to wrap. We won't construct a new object if it's passed.
+
+        Returns:
+            EncodedMatrix object.
+        """
+        # wrapping
+        if data is not None:
+            self.data = data
+        # constructing a new object
+        else:
+            if not isinstance(context, ts.Context):
+                raise TypeError("context must be a tenseal.Context")
+            if not isinstance(matrix, ts.PlainTensor):
+                matrix = ts.plain_tensor(matrix, dtype="float")
+            if len(matrix.shape) != 2:
+                raise ValueError("can only encode a matrix")
+            self.data = ts._ts_cpp.EncodedMatrix(context.data, matrix.data, scale)
+
+    @property
+    def data(self) -> ts._ts_cpp.EncodedMatrix:
+        """Get the wrapped low level EncodedMatrix object"""
+        return self._data
+
+    @data.setter
+    def data(self, value: ts._ts_cpp.EncodedMatrix):
+        """Set the wrapped low level EncodedMatrix object"""
+        if not isinstance(value, ts._ts_cpp.EncodedMatrix):
+            raise TypeError("value must be of type _ts_cpp.EncodedMatrix")
+        self._data = value
+
+    @property
+    def shape(self) -> List[int]:
+        return self.data.shape()
+
+    def scale(self) -> float:
+        return self.data.scale()
+
+    def clear(self):
+        """Release the diagonals switched down to lower levels by the multiplications,
+        only the encoded ones are kept."""
+        self.data.clear()
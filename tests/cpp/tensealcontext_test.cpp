@@ -1,6 +1,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "tenseal/cpp/tenseal.h"
+#include "tenseal/cpp/utils/parallel.h"
 #include "tenseal/cpp/utils/threadpool.h"
 
 namespace tenseal {
@@ -33,6 +34,50 @@ TEST_P(TenSEALContextTest, TestCreateFail) {
     EXPECT_THROW(auto ctx = TenSEALContext::Create("invalid"), std::exception);
 }
 
+TEST_F(TenSEALContextTest, TestSelectParameters) {
+    auto bit_sizes = [](const EncryptionParameters& parms) {
+        vector<int> sizes;
+        for (auto& modulus : parms.coeff_modulus())
+            sizes.push_back(modulus.bit_count());
+        return sizes;
+    };
+
+    // the depth of polyval for a degree 3 polynomial
+    ASSERT_EQ(polyval_depth(3), 2);
+    auto [ckks_parms, scale] = select_ckks_parameters(polyval_depth(3), 20, 8);
+    ASSERT_EQ(ckks_parms.poly_modulus_degree(), 8192);
+    ASSERT_THAT(bit_sizes(ckks_parms), ElementsAreArray({60, 40, 40, 60}));
+    ASSERT_EQ(scale, std::pow(2, 40));
+
+    auto ctx = TenSEALContext::Create(scheme_type::ckks,
+                                      ckks_parms.poly_modulus_degree(), -1,
+                                      bit_sizes(ckks_parms));
+    ctx->global_scale(scale);
+    auto vec = CKKSVector::Create(ctx, vector<double>({1, 2, 3}));
+    auto result = vec->polyval(vector<double>({1, 1, 1, 1}))->decrypt();
+    ASSERT_NEAR(result.data()[2], 40, 0.01);
+
+    // larger vectors or security levels need a larger degree
+    ASSERT_EQ(select_ckks_parameters(2, 20, 8192).first.poly_modulus_degree(),
+              16384);
+    ASSERT_EQ(select_ckks_parameters(2, 20, 8, sec_level_type::tc256)
+                  .first.poly_modulus_degree(),
+              16384);
+    EXPECT_THROW(select_ckks_parameters(2, 40, 8), invalid_argument);
+    EXPECT_THROW(select_ckks_parameters(100, 20, 8), invalid_argument);
+
+    auto bfv_parms = select_bfv_parameters(2, 20, 4096);
+    ASSERT_EQ(bfv_parms.poly_modulus_degree(), 8192);
+    ctx = TenSEALContext::Create(scheme_type::bfv,
+                                 bfv_parms.poly_modulus_degree(),
+                                 bfv_parms.plain_modulus().value(),
+                                 bit_sizes(bfv_parms));
+    auto bfv_vec = BFVVector::Create(ctx, vector<int64_t>({1, 2, 3}));
+    bfv_vec->square_inplace()->square_inplace();
+    ASSERT_THAT(bfv_vec->decrypt().data(), ElementsAreArray({1, 16, 81}));
+    EXPECT_THROW(select_bfv_parameters(100, 20, 8), invalid_argument);
+}
+
 TEST_P(TenSEALContextTest, TestSerialization) {
     auto enc_type = get<1>(GetParam());
     auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
@@ -68,6 +113,388 @@ TEST_P(TenSEALContextTest, TestSerialization) {
     ASSERT_EQ(orig_galoiskeys.size(), serial_galoiskeys.size());
 }
 
+TEST_P(TenSEALContextTest, TestSelectiveGaloisKeys) {
+    auto enc_type = get<1>(GetParam());
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type);
+    auto galois_tool = ctx->seal_context()->key_context_data()->galois_tool();
+
+    ctx->generate_galois_keys(vector<int>{1, -3, 100});
+    for (auto step : {1, -3, 100})
+        ASSERT_TRUE(
+            ctx->galois_keys()->has_key(galois_tool->get_elt_from_step(step)));
+    ASSERT_FALSE(
+        ctx->galois_keys()->has_key(galois_tool->get_elt_from_step(2)));
+    ASSERT_EQ(ctx->galois_keys()->size(), 3);
+
+    // both the private and the public contexts keep the selected keys only
+    for (bool save_secret_key : {true, false}) {
+        auto buff = ctx->save(/*save_public_key=*/true, save_secret_key,
+                              /*save_galois_keys=*/true,
+                              /*save_relin_keys=*/true);
+        auto recreated_ctx = TenSEALContext::Create(buff);
+        ASSERT_EQ(recreated_ctx->galois_keys()->size(), 3);
+        ASSERT_TRUE(recreated_ctx->galois_keys()->has_key(
+            galois_tool->get_elt_from_step(100)));
+    }
+
+    EXPECT_THROW(ctx->generate_galois_keys(vector<int>{}), invalid_argument);
+    EXPECT_THROW(ctx->generate_galois_keys(vector<int>{8192}),
+                 std::exception);
+}
+
+TEST_P(TenSEALContextTest, TestParallelGaloisKeys) {
+    auto enc_type = get<1>(GetParam());
+    for (size_t n_threads : {1, 4}) {
+        auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                          {60, 40, 40, 60}, enc_type,
+                                          n_threads);
+        ctx->global_scale(std::pow(2, 40));
+        auto galois_tool =
+            ctx->seal_context()->key_context_data()->galois_tool();
+
+        ctx->generate_galois_keys();
+        ASSERT_EQ(ctx->galois_keys()->size(),
+                  galois_tool->get_elts_all().size());
+        ASSERT_EQ(ctx->galois_keys()->parms_id(),
+                  ctx->seal_context()->key_parms_id());
+
+        // the merged keys are valid and survive a serialization round-trip
+        auto buff = ctx->save(/*save_public_key=*/true,
+                              /*save_secret_key=*/true,
+                              /*save_galois_keys=*/true,
+                              /*save_relin_keys=*/true);
+        auto recreated_ctx = TenSEALContext::Create(buff);
+        auto vec = CKKSVector::Create(recreated_ctx,
+                                      vector<double>({1, 2, 3, 4, 5, 6, 7}));
+        auto sum = vec->sum()->decrypt();
+        ASSERT_NEAR(sum.data()[0], 28, 0.01);
+    }
+}
+
+TEST_F(TenSEALContextTest, TestSeededKeys) {
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60},
+                                      encryption_type::symmetric, 4);
+    ctx->global_scale(std::pow(2, 40));
+    ctx->generate_galois_keys();
+
+    // the generated keys are saved seeded, the loaded ones in full
+    auto buff = ctx->save(/*save_public_key=*/false,
+                          /*save_secret_key=*/false,
+                          /*save_galois_keys=*/true,
+                          /*save_relin_keys=*/true);
+    auto server_ctx = TenSEALContext::Create(buff);
+    ASSERT_EQ(server_ctx->galois_keys()->size(), ctx->galois_keys()->size());
+    auto server_buff = server_ctx->save(/*save_public_key=*/false,
+                                        /*save_secret_key=*/false,
+                                        /*save_galois_keys=*/true,
+                                        /*save_relin_keys=*/true);
+    ASSERT_LT(buff.size(), server_buff.size() * 6 / 10);
+
+    // the seeded keys are usable once loaded
+    auto vec = CKKSVector::Create(ctx, vector<double>({1, 2, 3, 4}));
+    auto server_vec = CKKSVector::Create(server_ctx, vec->save());
+    server_vec->sum_inplace();
+    auto result = CKKSVector::Create(ctx, server_vec->save());
+    ASSERT_NEAR(result->decrypt().data()[0], 10, 0.01);
+
+    auto rotated = vec->ciphertext()[0];
+    server_ctx->evaluator->rotate_vector_inplace(rotated, 1,
+                                                 *server_ctx->galois_keys());
+    Plaintext plain;
+    ctx->decryptor()->decrypt(rotated, plain);
+    vector<double> values;
+    ctx->decode<CKKSEncoder>(plain, values);
+    ASSERT_NEAR(values[0], 2, 0.01);
+    ASSERT_NEAR(values[2], 4, 0.01);
+
+    // the lazily generated keys are seeded too
+    auto lazy_ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                           {60, 40, 40, 60},
+                                           encryption_type::symmetric);
+    lazy_ctx->lazy_galois_keys(true);
+    lazy_ctx->galois_keys(vector<int>{1});
+    lazy_ctx->galois_keys(vector<int>{2});
+    auto lazy_buff = lazy_ctx->save(/*save_public_key=*/false,
+                                    /*save_secret_key=*/false,
+                                    /*save_galois_keys=*/true,
+                                    /*save_relin_keys=*/false);
+    TenSEALContextProto proto;
+    ASSERT_TRUE(proto.ParseFromString(lazy_buff));
+    ASSERT_EQ(proto.public_context().seeded_galois_keys_size(), 2);
+    ASSERT_EQ(TenSEALContext::Create(lazy_buff)->galois_keys()->size(), 2);
+}
+
+TEST_P(TenSEALContextTest, TestLazyGaloisKeys) {
+    auto enc_type = get<1>(GetParam());
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type);
+    ctx->global_scale(std::pow(2, 40));
+    ctx->lazy_galois_keys(true);
+    ASSERT_TRUE(ctx->lazy_galois_keys());
+    ASSERT_FALSE(ctx->has_galois_key());
+
+    auto keys = ctx->galois_keys(vector<int>{1, 2});
+    ASSERT_EQ(keys->size(), 2);
+    // the keys are only generated once
+    ASSERT_EQ(ctx->galois_keys(vector<int>{2, 0}), keys);
+
+    auto more_keys = ctx->galois_keys(vector<int>{-3});
+    ASSERT_EQ(more_keys->size(), 3);
+    ASSERT_EQ(keys->size(), 2);
+
+    // the operations generate the keys they use
+    auto vec = CKKSVector::Create(ctx, vector<double>({1, 2, 3, 4, 5, 6}));
+    auto sum = vec->sum()->decrypt();
+    ASSERT_NEAR(sum.data()[0], 21, 0.01);
+    ASSERT_EQ(ctx->galois_keys()->size(), 4);
+
+    vector<thread> threads;
+    for (int step = 10; step < 14; step++)
+        threads.emplace_back([&ctx, step]() {
+            ctx->galois_keys(vector<int>{step, 1});
+        });
+    for (auto& t : threads) t.join();
+    ASSERT_EQ(ctx->galois_keys()->size(), 8);
+
+    // the lazily generated keys are kept by the private contexts
+    auto buff = ctx->save(/*save_public_key=*/true, /*save_secret_key=*/true,
+                          /*save_galois_keys=*/true,
+                          /*save_relin_keys=*/true);
+    auto recreated_ctx = TenSEALContext::Create(buff);
+    ASSERT_TRUE(recreated_ctx->lazy_galois_keys());
+    ASSERT_EQ(recreated_ctx->galois_keys()->size(), 8);
+
+    // without a secret key, nothing can be generated
+    if (enc_type == encryption_type::symmetric) return;
+    auto public_ctx = TenSEALContext::Create(
+        ctx->save(/*save_public_key=*/true, /*save_secret_key=*/false,
+                  /*save_galois_keys=*/false, /*save_relin_keys=*/true));
+    EXPECT_THROW(public_ctx->galois_keys(vector<int>{1}), invalid_argument);
+}
+
+TEST_P(TenSEALContextTest, TestGaloisKeyStore) {
+    auto enc_type = get<1>(GetParam());
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type);
+    ctx->global_scale(std::pow(2, 40));
+    ctx->generate_galois_keys(vector<int>{1, 2, 4, -1});
+
+    auto path = TempDir() + "tenseal_galois_keys_" +
+                std::to_string(static_cast<int>(enc_type));
+    auto fingerprint = ctx->fingerprint();
+    ctx->store_galois_keys(path);
+    ASSERT_TRUE(ctx->has_galois_key());
+    // the store is fingerprinted by the digest of the keys in its header
+    ASSERT_EQ(ctx->fingerprint(), fingerprint);
+
+    // the keys are only loaded from the store when a step needs them
+    ASSERT_EQ(ctx->galois_keys(vector<int>{1})->size(), 1);
+    // the missing step is rotated by its NAF decomposition, 4 - 1
+    ASSERT_EQ(ctx->galois_keys(vector<int>{3})->size(), 3);
+    // the element of the step 2, 3^2
+    ASSERT_EQ(ctx->galois_elt_keys({9})->size(), 4);
+    ASSERT_EQ(ctx->fingerprint(), fingerprint);
+    ASSERT_EQ(ctx->galois_keys()->size(), 4);
+
+    auto vec = CKKSVector::Create(ctx, vector<double>({1, 2, 3, 4}));
+    auto sum = vec->sum()->decrypt();
+    ASSERT_NEAR(sum.data()[0], 10, 0.01);
+
+    // a context loaded without its Galois keys can use the store
+    auto loaded_ctx = TenSEALContext::Create(
+        ctx->save(/*save_public_key=*/true, /*save_secret_key=*/true,
+                  /*save_galois_keys=*/false, /*save_relin_keys=*/true));
+    ASSERT_FALSE(loaded_ctx->has_galois_key());
+    loaded_ctx->load_galois_keys(path);
+    ASSERT_TRUE(loaded_ctx->has_galois_key());
+    vec->link_tenseal_context(loaded_ctx);
+    sum = vec->sum()->decrypt();
+    ASSERT_NEAR(sum.data()[0], 10, 0.01);
+
+    // replacing the store leaves the mapped file readable, and concurrent
+    // writers of the same path write distinct temporary files
+    vector<thread> writers;
+    for (int i = 0; i < 2; i++)
+        writers.emplace_back([&ctx, &loaded_ctx, &path]() {
+            GaloisKeyStore::Create(path, ctx->seal_context(),
+                                   *loaded_ctx->galois_keys());
+        });
+    for (auto& t : writers) t.join();
+    auto store = GaloisKeyStore::Open(path, ctx->seal_context());
+    ASSERT_EQ(store->galois_elts().size(), 4);
+
+    // the saved contexts embed the stored keys
+    auto recreated_ctx = duplicate(loaded_ctx);
+    ASSERT_EQ(recreated_ctx->galois_keys()->size(), 4);
+    auto public_ctx = TenSEALContext::Create(
+        loaded_ctx->save(/*save_public_key=*/true, /*save_secret_key=*/false,
+                         /*save_galois_keys=*/true, /*save_relin_keys=*/true));
+    ASSERT_EQ(public_ctx->galois_keys()->size(), 4);
+
+    // the keys loaded from the store are released beyond the capacity
+    auto resident_ctx = TenSEALContext::Create(
+        ctx->save(/*save_public_key=*/true, /*save_secret_key=*/true,
+                  /*save_galois_keys=*/false, /*save_relin_keys=*/true));
+    resident_ctx->resident_galois_keys(2);
+    resident_ctx->load_galois_keys(path);
+    ASSERT_EQ(resident_ctx->galois_keys(vector<int>{1})->size(), 1);
+    ASSERT_EQ(resident_ctx->galois_keys(vector<int>{2})->size(), 2);
+    // the least recently loaded key, of the step 1, is released first
+    auto galois_tool = ctx->seal_context()->key_context_data()->galois_tool();
+    auto keys = resident_ctx->galois_keys(vector<int>{4});
+    ASSERT_EQ(keys->size(), 2);
+    ASSERT_FALSE(keys->has_key(galois_tool->get_elt_from_step(1)));
+    // the keys of a single operation are all kept
+    ASSERT_EQ(resident_ctx->galois_keys(vector<int>{1, 2, -1})->size(), 3);
+
+    auto other_ctx = TenSEALContext::Create(scheme_type::ckks, 4096, -1,
+                                            {40, 20, 40}, enc_type);
+    EXPECT_THROW(other_ctx->load_galois_keys(path), invalid_argument);
+    EXPECT_THROW(ctx->load_galois_keys(path + ".missing"), invalid_argument);
+
+    std::remove(path.c_str());
+}
+
+TEST_P(TenSEALContextTest, TestFingerprint) {
+    auto enc_type = get<1>(GetParam());
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type);
+    ctx->global_scale(std::pow(2, 40));
+    ctx->generate_galois_keys(vector<int>{1, 2});
+
+    auto recreated_ctx = duplicate(ctx);
+    ASSERT_EQ(ctx->fingerprint(), ctx->fingerprint());
+    // the private contexts regenerate their Galois and Relinearization keys
+    ASSERT_NE(ctx->fingerprint(), recreated_ctx->fingerprint());
+    ASSERT_TRUE(ctx->equals(recreated_ctx));
+
+    recreated_ctx->global_scale(std::pow(2, 30));
+    ASSERT_FALSE(ctx->equals(recreated_ctx));
+
+    auto other_ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                            {60, 40, 40, 60}, enc_type);
+    other_ctx->global_scale(std::pow(2, 40));
+    ASSERT_FALSE(ctx->equals(other_ctx));
+    ASSERT_NE(ctx->fingerprint(), other_ctx->fingerprint());
+
+    // the contexts without comparable keys aren't equal
+    auto keyless = ctx->save(/*save_public_key=*/false,
+                             /*save_secret_key=*/false,
+                             /*save_galois_keys=*/false,
+                             /*save_relin_keys=*/false);
+    auto keyless_ctx = TenSEALContext::Create(keyless);
+    ASSERT_FALSE(keyless_ctx->equals(ctx));
+    ASSERT_FALSE(ctx->equals(keyless_ctx));
+    ASSERT_FALSE(keyless_ctx->equals(TenSEALContext::Create(keyless)));
+    ASSERT_TRUE(keyless_ctx->equals(keyless_ctx));
+}
+
+TEST_P(TenSEALContextTest, TestContextRegistry) {
+    auto enc_type = get<1>(GetParam());
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type);
+    ctx->global_scale(std::pow(2, 40));
+    ctx->generate_galois_keys(vector<int>{1, 2});
+    auto buff = ctx->save(/*save_public_key=*/true, /*save_secret_key=*/false,
+                          /*save_galois_keys=*/true, /*save_relin_keys=*/true);
+
+    TenSEALContext::use_context_registry(true);
+    TenSEALContext::clear_context_registry();
+    auto first = TenSEALContext::Create(buff);
+    auto second = TenSEALContext::Create(buff);
+    TenSEALContext::use_context_registry(false);
+
+    // the identical contexts share everything they loaded
+    ASSERT_EQ(first->seal_context(), second->seal_context());
+    ASSERT_EQ(first->evaluator, second->evaluator);
+    ASSERT_EQ(first->galois_keys(), second->galois_keys());
+    ASSERT_EQ(first->relin_keys(), second->relin_keys());
+    ASSERT_EQ(first->fingerprint(), second->fingerprint());
+    // the symmetric public contexts hold no key to compare
+    ASSERT_EQ(first->equals(ctx), enc_type == encryption_type::asymmetric);
+
+    // but not their mutable state
+    second->global_scale(std::pow(2, 30));
+    ASSERT_EQ(first->global_scale(), std::pow(2, 40));
+    ASSERT_NE(first->fingerprint(), second->fingerprint());
+
+    auto unregistered = TenSEALContext::Create(buff);
+    ASSERT_NE(unregistered->seal_context(), first->seal_context());
+    ASSERT_EQ(unregistered->fingerprint(), first->fingerprint());
+
+    // the contexts keep working once the registry released them
+    TenSEALContext::clear_context_registry();
+    if (enc_type != encryption_type::symmetric) {
+        auto vec = CKKSVector::Create(first, vector<double>({1, 2, 3}));
+        auto decrypted = vec->decrypt(ctx->secret_key());
+        ASSERT_NEAR(decrypted.data()[2], 3, 0.01);
+    }
+
+    // the recently used entries outlive the contexts, so a context loaded
+    // once the previous one was released reuses them
+    TenSEALContext::use_context_registry(true);
+    auto released = TenSEALContext::Create(buff);
+    weak_ptr<SEALContext> released_backend = released->seal_context();
+    weak_ptr<RelinKeys> released_keys = released->relin_keys();
+    released.reset();
+    ASSERT_FALSE(released_backend.expired());
+    auto reloaded = TenSEALContext::Create(buff);
+    ASSERT_EQ(reloaded->seal_context(), released_backend.lock());
+    ASSERT_EQ(reloaded->relin_keys(), released_keys.lock());
+
+    // past the capacity, the least recently used entries are released
+    reloaded.reset();
+    TenSEALContext::context_registry_capacity(0);
+    ASSERT_TRUE(released_backend.expired());
+    ASSERT_TRUE(released_keys.expired());
+    ASSERT_EQ(ContextRegistry::instance().size(), 0);
+    TenSEALContext::context_registry_capacity(
+        ContextRegistry::default_capacity);
+    TenSEALContext::use_context_registry(false);
+}
+
+TEST_P(TenSEALContextTest, TestCopy) {
+    auto enc_type = get<1>(GetParam());
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type);
+    ctx->global_scale(std::pow(2, 40));
+    ctx->generate_galois_keys(vector<int>{1});
+
+    auto copy = ctx->copy();
+    // the immutable parts are shared
+    ASSERT_EQ(copy->seal_context(), ctx->seal_context());
+    ASSERT_EQ(copy->secret_key(), ctx->secret_key());
+    ASSERT_EQ(copy->relin_keys(), ctx->relin_keys());
+    ASSERT_EQ(copy->galois_keys(), ctx->galois_keys());
+    ASSERT_TRUE(copy->equals(ctx));
+
+    // the settings aren't
+    copy->global_scale(std::pow(2, 21));
+    copy->auto_rescale(false);
+    ASSERT_EQ(ctx->global_scale(), std::pow(2, 40));
+    ASSERT_TRUE(ctx->auto_rescale());
+
+    // replacing the keys of the copy leaves the original untouched
+    copy->generate_galois_keys(vector<int>{2});
+    ASSERT_EQ(ctx->galois_keys()->size(), 1);
+    ASSERT_EQ(copy->galois_keys()->size(), 1);
+    ASSERT_NE(copy->galois_keys(), ctx->galois_keys());
+
+    auto vec = CKKSVector::Create(ctx, vector<double>({1, 2, 3}));
+    auto vec_copy = vec->deepcopy();
+    ASSERT_NE(vec_copy->tenseal_context(), ctx);
+    ASSERT_EQ(vec_copy->tenseal_context()->galois_keys(), ctx->galois_keys());
+    auto result = vec_copy->decrypt();
+    ASSERT_NEAR(result.data()[2], 3, 0.01);
+
+    if (enc_type == encryption_type::symmetric) return;
+    copy->make_context_public();
+    ASSERT_TRUE(copy->is_public());
+    ASSERT_TRUE(ctx->is_private());
+}
+
 TEST_P(TenSEALContextTest, TestDispatcher) {
     auto enc_type = get<1>(GetParam());
     auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
@@ -77,6 +504,299 @@ TEST_P(TenSEALContextTest, TestDispatcher) {
     ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1, {60, 40, 40, 60},
                                  enc_type, 8);
     ASSERT_EQ(ctx->dispatcher_size(), 8);
+
+    // the Galois keys are generated without starting the context's workers
+    ctx->generate_galois_keys();
+    ASSERT_TRUE(ctx->dispatcher_metrics().tasks_executed.empty());
+    ASSERT_TRUE(duplicate(ctx)->dispatcher_metrics().tasks_executed.empty());
+}
+
+TEST_F(TenSEALContextTest, TestDispatcherWorkStealing) {
+    sync::ThreadPool pool(4);
+
+    // a slow task shouldn't block the tasks queued behind it
+    std::promise<void> release;
+    auto blocked = pool.enqueue_task(
+        [](std::shared_future<void> wait) { wait.wait(); },
+        release.get_future().share());
+
+    vector<future<size_t>> futures;
+    for (size_t i = 0; i < 64; i++)
+        futures.push_back(pool.enqueue_task([](size_t x) { return x; }, i));
+
+    size_t total = 0;
+    for (auto& f : futures) total += f.get();
+    ASSERT_EQ(total, 64 * 63 / 2);
+
+    release.set_value();
+    blocked.get();
+}
+
+TEST_F(TenSEALContextTest, TestDispatcherExternalWait) {
+    sync::ThreadPool pool(1);
+
+    // a thread outside of the pool doesn't run the tasks of other callers
+    // while it waits, only the workers do
+    std::promise<void> release;
+    auto blocked = pool.enqueue_task(
+        [](std::shared_future<void> wait) { wait.wait(); },
+        release.get_future().share());
+    auto task = pool.enqueue_task([]() { return this_thread::get_id(); });
+
+    thread releaser([&release]() {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        release.set_value();
+    });
+    ASSERT_FALSE(pool.run_pending_task());
+    pool.wait(task);
+    ASSERT_NE(task.get(), this_thread::get_id());
+    releaser.join();
+    blocked.get();
+    ASSERT_EQ(pool.metrics().helper_tasks_executed, 0);
+}
+
+TEST_F(TenSEALContextTest, TestDispatcherNestedWait) {
+    auto pool = make_shared<sync::ThreadPool>(2);
+
+    // every worker blocks on inner tasks, which only complete if the waiting
+    // workers run them.
+    auto outer = [pool](size_t x) {
+        vector<future<size_t>> inner;
+        for (size_t i = 0; i < 8; i++)
+            inner.push_back(
+                pool->enqueue_task([x](size_t y) { return x * y; }, i));
+
+        size_t total = 0;
+        for (auto& f : inner) {
+            pool->wait(f);
+            total += f.get();
+        }
+        return total;
+    };
+
+    vector<future<size_t>> futures;
+    for (size_t i = 0; i < 4; i++)
+        futures.push_back(pool->enqueue_task(outer, i));
+
+    size_t total = 0;
+    for (auto& f : futures) {
+        pool->wait(f);
+        total += f.get();
+    }
+    ASSERT_EQ(total, (0 + 1 + 2 + 3) * 28);
+}
+
+TEST_F(TenSEALContextTest, TestDispatcherTaskQueue) {
+    sync::mpmc_queue<sync::unique_task> queue(4);
+    ASSERT_EQ(queue.capacity(), 4);
+
+    size_t calls = 0;
+    for (size_t i = 0; i < queue.capacity(); i++)
+        ASSERT_TRUE(queue.try_push([&calls]() { calls++; }));
+    ASSERT_FALSE(queue.try_push([&calls]() { calls++; }));
+
+    // captures bigger than the inline buffer are moved to the heap
+    array<char, 2 * sync::unique_task::inline_size> big{};
+    sync::unique_task task;
+    ASSERT_TRUE(queue.try_pop(task));
+    task();
+    ASSERT_TRUE(queue.try_push([&calls, big]() { calls += big.size(); }));
+
+    while (queue.try_pop(task)) task();
+    ASSERT_EQ(calls, queue.capacity() + big.size());
+
+    // the tasks capturing a few references are queued without allocation
+    auto small = [&calls, &queue]() { calls += queue.size(); };
+    auto heavy = [&calls, big]() { calls += big.size(); };
+    ASSERT_TRUE(sync::ThreadPool::inline_task<decltype(small)>());
+    ASSERT_FALSE(sync::ThreadPool::inline_task<decltype(heavy)>());
+}
+
+TEST_F(TenSEALContextTest, TestDispatcherWorkStealingQueue) {
+    sync::work_stealing_queue<size_t> queue(4);
+    ASSERT_EQ(queue.capacity(), 4);
+
+    for (size_t i = 0; i < queue.capacity(); i++)
+        ASSERT_TRUE(queue.try_push(size_t(i)));
+    ASSERT_FALSE(queue.try_push(size_t(4)));
+    ASSERT_EQ(queue.size(), 4);
+
+    // the owner pops the most recent item, the thieves take the oldest one
+    size_t item;
+    ASSERT_TRUE(queue.pop(item));
+    ASSERT_EQ(item, 3);
+    ASSERT_TRUE(queue.steal(item));
+    ASSERT_EQ(item, 0);
+    ASSERT_TRUE(queue.try_push(size_t(4)));
+    ASSERT_TRUE(queue.try_push(size_t(5)));
+
+    // every item is taken once by the owner and the concurrent thieves
+    std::atomic_size_t taken = 3 + 0;
+    vector<thread> thieves;
+    for (int i = 0; i < 2; i++)
+        thieves.emplace_back([&queue, &taken]() {
+            size_t stolen;
+            while (taken < 10000 * 9999 / 2)
+                if (queue.steal(stolen)) taken += stolen;
+        });
+    for (size_t i = 6; i < 10000; i++) {
+        while (!queue.try_push(size_t(i)))
+            if (queue.pop(item)) taken += item;
+    }
+    while (queue.pop(item)) taken += item;
+    for (auto& t : thieves) t.join();
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(taken, 10000 * 9999 / 2);
+}
+
+TEST_F(TenSEALContextTest, TestDispatcherMemoryPools) {
+    sync::ThreadPool pool(2);
+
+    auto global = sync::ThreadPool::memory_pool();
+    ASSERT_EQ(global, MemoryManager::GetPool());
+
+    auto worker = pool.enqueue_task([]() {
+        auto handle = sync::ThreadPool::memory_pool();
+        auto buffer = seal::util::allocate<uint64_t>(1024, handle);
+        return handle;
+    });
+    auto handle = worker.get();
+    ASSERT_NE(handle, global);
+
+    auto usage = pool.memory_usage();
+    ASSERT_EQ(usage.size(), 2);
+    ASSERT_GT(usage[0] + usage[1], 0);
+}
+
+TEST_F(TenSEALContextTest, TestDispatcherAffinity) {
+    ASSERT_THAT(sync::parse_cpu_list("0-3,8,10-11\n"),
+                ElementsAre(0, 1, 2, 3, 8, 10, 11));
+    EXPECT_THROW(sync::parse_cpu_list("3-1"), invalid_argument);
+
+    sync::ThreadAffinity affinity{{2, 3}};
+    ASSERT_THAT(affinity.worker_cpus(0), ElementsAre(2));
+    ASSERT_THAT(affinity.worker_cpus(3), ElementsAre(3));
+    affinity.pin_to_core = false;
+    ASSERT_THAT(affinity.worker_cpus(3), ElementsAre(2, 3));
+
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60},
+                                      encryption_type::asymmetric, 2);
+    ctx->dispatcher_affinity(sync::ThreadAffinity{{0}});
+    ASSERT_THAT(ctx->dispatcher()->affinity().cpus, ElementsAre(0));
+}
+
+TEST_F(TenSEALContextTest, TestParallelReduce) {
+    sync::ThreadPool pool(4);
+
+    auto sum_range = [](size_t start, size_t end) {
+        size_t total = 0;
+        for (size_t i = start; i < end; i++) total += i;
+        return total;
+    };
+    auto reduce = [](size_t& acc, size_t other) { acc += other; };
+
+    for (size_t grain : {1, 7, 1000}) {
+        auto total = sync::parallel_reduce(pool, 1000, 4, size_t(0),
+                                           sum_range, reduce, grain);
+        ASSERT_EQ(total, 1000 * 999 / 2);
+    }
+
+    vector<size_t> hits(100, 0);
+    sync::parallel_for(pool, hits.size(), 4, [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; i++) hits[i]++;
+    });
+    for (auto hit : hits) ASSERT_EQ(hit, 1);
+
+    EXPECT_THROW(sync::parallel_for(pool, 100, 4,
+                                    [](size_t start, size_t /*end*/) {
+                                        if (start > 50)
+                                            throw invalid_argument("failed");
+                                    }),
+                 invalid_argument);
+}
+
+TEST_F(TenSEALContextTest, TestDispatcherMetrics) {
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60},
+                                      encryption_type::asymmetric, 2);
+    ASSERT_TRUE(ctx->dispatcher_metrics().tasks_executed.empty());
+
+    auto pool = ctx->dispatcher();
+    vector<future<size_t>> futures;
+    for (size_t i = 0; i < 32; i++)
+        futures.push_back(pool->enqueue_task(
+            [](size_t x) {
+                this_thread::sleep_for(chrono::microseconds(100));
+                return x;
+            },
+            i));
+    for (auto& f : futures) pool->wait(f);
+
+    auto metrics = ctx->dispatcher_metrics();
+    ASSERT_EQ(metrics.queue_depth.size(), 2);
+    ASSERT_EQ(metrics.tasks_executed.size(), 2);
+    ASSERT_EQ(metrics.tasks_executed[0] + metrics.tasks_executed[1] +
+                  metrics.helper_tasks_executed,
+              32);
+    ASSERT_EQ(metrics.task_duration.count(), 32);
+    ASSERT_EQ(metrics.queue_delay.count(), 32);
+    ASSERT_GE(metrics.task_duration.quantile(0.5), 100);
+
+    ASSERT_EQ(sync::latency_histogram::bucket(chrono::microseconds(0)), 0);
+    ASSERT_EQ(sync::latency_histogram::bucket(chrono::microseconds(3)), 2);
+    ASSERT_EQ(sync::latency_histogram::bucket(chrono::hours(1000)),
+              sync::latency_histogram::bucket_count - 1);
+}
+
+TEST_F(TenSEALContextTest, TestCancellation) {
+    sync::ThreadPool pool(4);
+    sync::cancellation_token token;
+
+    atomic_size_t chunks = 0;
+    auto job = [&](size_t /*start*/, size_t /*end*/) {
+        if (++chunks == 2) token.cancel();
+        // the workers observe the token of the calling thread
+        ASSERT_TRUE(sync::cancellation_token::current().has_value());
+    };
+
+    {
+        sync::cancellation_scope scope(token);
+        EXPECT_THROW(sync::parallel_for(pool, 1000, 4, job),
+                     sync::operation_cancelled);
+        EXPECT_THROW(sync::check_cancellation(), sync::operation_cancelled);
+    }
+    // the remaining chunks were skipped, and the scope was restored
+    ASSERT_LT(chunks.load(), 4 * sync::chunks_per_job);
+    ASSERT_FALSE(sync::cancellation_token::current().has_value());
+    sync::check_cancellation();
+
+    auto expired = sync::cancellation_token::with_timeout(chrono::seconds(0));
+    ASSERT_TRUE(expired.cancelled());
+    auto pending = sync::cancellation_token::with_timeout(chrono::hours(1));
+    ASSERT_FALSE(pending.cancelled());
+}
+
+TEST_P(TenSEALContextTest, TestSharedDispatcher) {
+    auto enc_type = get<1>(GetParam());
+    TenSEALContext::use_shared_dispatcher(true);
+    auto ctx1 = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                       {60, 40, 40, 60}, enc_type, 2);
+    auto ctx2 = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                       {60, 40, 40, 60}, enc_type, 4);
+    TenSEALContext::use_shared_dispatcher(false);
+
+    ASSERT_EQ(ctx1->dispatcher(), TenSEALContext::shared_dispatcher());
+    ASSERT_EQ(ctx1->dispatcher(), ctx2->dispatcher());
+    ASSERT_EQ(ctx1->dispatcher_size(), 2);
+    ASSERT_EQ(ctx2->dispatcher_size(), 4);
+
+    auto ctx3 = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                       {60, 40, 40, 60}, enc_type);
+    ASSERT_NE(ctx3->dispatcher(), ctx1->dispatcher());
+
+    ctx3->dispatcher(ctx1->dispatcher());
+    ASSERT_EQ(ctx3->dispatcher(), ctx1->dispatcher());
 }
 
 TEST_P(TenSEALContextTest, TestCreateBFV) {
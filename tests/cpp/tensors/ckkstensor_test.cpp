@@ -106,6 +106,45 @@ TEST_P(CKKSTensorTest, TestDecryptCKKSWithBatching) {
     ASSERT_TRUE(are_close(decr.data(), {1, 2, 3}));
 }
 
+TEST_P(CKKSTensorTest, TestDecryptCKKSParallel) {
+    auto should_serialize_first = get<0>(GetParam());
+    auto enc_type = get<1>(GetParam());
+
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type,
+                                      /*n_threads=*/4);
+    ASSERT_TRUE(ctx != nullptr);
+
+    std::vector<double> data(100);
+    std::vector<int64_t> expected(100);
+    for (size_t i = 0; i < data.size(); i++) data[i] = expected[i] = i;
+    auto l = CKKSTensor::Create(ctx, data, std::pow(2, 40), false);
+
+    if (should_serialize_first) {
+        l = duplicate(l);
+    }
+
+    ASSERT_TRUE(are_close(l->decrypt().data(), expected));
+
+    // the Decryptor of a secret key is built once
+    auto sk = make_shared<SecretKey>(*ctx->secret_key());
+    ASSERT_EQ(ctx->decryptor(ctx->secret_key()), ctx->decryptor());
+    auto decryptor = ctx->decryptor(sk);
+    ASSERT_NE(decryptor, ctx->decryptor());
+    ASSERT_EQ(ctx->decryptor(sk), decryptor);
+    ASSERT_TRUE(are_close(l->decrypt(sk).data(), expected));
+
+    // the Decryptor of a released key is dropped on the next lookup
+    auto other = make_shared<SecretKey>(*ctx->secret_key());
+    auto other_decryptor = ctx->decryptor(other);
+    weak_ptr<Decryptor> released = decryptor;
+    decryptor.reset();
+    sk.reset();
+    ASSERT_FALSE(released.expired());
+    ASSERT_EQ(ctx->decryptor(other), other_decryptor);
+    ASSERT_TRUE(released.expired());
+}
+
 TEST_P(CKKSTensorTest, TestCKKSSumNoBatching) {
     auto should_serialize_first = get<0>(GetParam());
     auto enc_type = get<1>(GetParam());
@@ -174,6 +213,27 @@ TEST_P(CKKSTensorTest, TestCKKSSumBatching) {
     ASSERT_TRUE(are_close(decr.data(), {6, 15}));
 }
 
+TEST_P(CKKSTensorTest, TestCKKSSumBatchingLazyKeys) {
+    auto enc_type = get<1>(GetParam());
+
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type, 4);
+    ASSERT_TRUE(ctx != nullptr);
+    ctx->lazy_galois_keys(true);
+
+    // every task of the sum asks for the missing keys, while their generation
+    // runs on the same dispatcher
+    vector<double> values(4 * 32);
+    for (size_t i = 0; i < values.size(); i++) values[i] = i / 32;
+    auto data = PlainTensor(values, vector<size_t>({4, 32}));
+    auto l = CKKSTensor::Create(ctx, data, std::pow(2, 40), true);
+
+    auto res = l->sum(0);
+    ASSERT_THAT(res->shape(), ElementsAreArray({32}));
+    ASSERT_TRUE(
+        are_close(res->decrypt().data(), vector<int64_t>(32, 0 + 1 + 2 + 3)));
+}
+
 TEST_P(CKKSTensorTest, TestCKKSPower) {
     auto should_serialize_first = get<0>(GetParam());
     auto enc_type = get<1>(GetParam());
@@ -193,6 +253,38 @@ TEST_P(CKKSTensorTest, TestCKKSPower) {
     ASSERT_TRUE(are_close(decr.data(), {1, 4, 9, 16, 25, 36}));
 }
 
+TEST_P(CKKSTensorTest, TestCKKSPlainOpsAtLevel) {
+    auto enc_type = get<1>(GetParam());
+
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type);
+    ASSERT_TRUE(ctx != nullptr);
+
+    auto data =
+        PlainTensor(vector<double>({1, 2, 3, 4, 5, 6}), vector<size_t>({2, 3}));
+    auto l = CKKSTensor::Create(ctx, data, std::pow(2, 40), false);
+    l->power_inplace(2);
+    auto parms_id = l->data()[0].parms_id();
+    ASSERT_NE(parms_id, ctx->seal_context()->first_parms_id());
+
+    auto res = l->add_plain(1.0);
+    ASSERT_TRUE(are_close(res->decrypt().data(), {2, 5, 10, 17, 26, 37}));
+    res = l->mul_plain(data);
+    ASSERT_TRUE(are_close(res->decrypt().data(), {1, 8, 27, 64, 125, 216}));
+
+    auto matrix =
+        PlainTensor(vector<double>({1, 0, 0, 1, 1, 1}), vector<size_t>({3, 2}));
+    res = l->matmul_plain(matrix);
+    ASSERT_TRUE(are_close(res->decrypt().data(), {10, 13, 52, 61}));
+    ASSERT_EQ(l->data()[0].parms_id(), parms_id);
+
+    // without auto_mod_switch, the operands are encoded at the top of the
+    // chain and SEAL rejects the mismatch
+    ctx->auto_mod_switch(false);
+    EXPECT_THROW(l->add_plain(1.0), invalid_argument);
+    EXPECT_THROW(l->mul_plain(data), invalid_argument);
+}
+
 TEST_P(CKKSTensorTest, TestAddBroadcasting) {
     auto enc_type = get<1>(GetParam());
 
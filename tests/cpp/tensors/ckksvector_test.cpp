@@ -271,6 +271,237 @@ TEST_P(CKKSVectorTest, TestCKKSPlainMatMul) {
     ASSERT_TRUE(are_close(decrypted_result.data(), expected_result));
 }
 
+TEST_F(CKKSVectorTest, TestCKKSEncodeCache) {
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60});
+    ctx->generate_galois_keys();
+    ctx->global_scale(std::pow(2, 40));
+
+    auto vec = CKKSVector::Create(ctx, std::vector<double>({1, 2, 3}));
+    auto weights = PlainTensor<double>(vector<double>{1, 2, 3});
+    vec->mul_plain(weights);
+    // disabled by default
+    ASSERT_EQ(ctx->encode_cache_stats().misses, 0);
+
+    ctx->encode_cache_capacity(8);
+    auto result = vec->mul_plain(weights);
+    ASSERT_EQ(ctx->encode_cache_stats().misses, 1);
+    result = vec->mul_plain(weights);
+    ASSERT_EQ(ctx->encode_cache_stats().hits, 1);
+    ASSERT_TRUE(are_close(result->decrypt().data(), {1, 4, 9}));
+
+    // the level is part of the key
+    result->mul_plain_inplace(weights);
+    ASSERT_EQ(ctx->encode_cache_stats().misses, 2);
+    ASSERT_TRUE(are_close(result->decrypt().data(), {1, 8, 27}));
+
+    // every diagonal of the matrix is cached
+    auto matrix = PlainTensor<double>(
+        vector<vector<double>>{{1, 2, 3}, {1, 2, 3}, {1, 2, 3}});
+    vec->matmul_plain(matrix);
+    result = vec->matmul_plain(matrix);
+    auto stats = ctx->encode_cache_stats();
+    ASSERT_EQ(stats.hits, 4);
+    ASSERT_EQ(stats.misses, 5);
+    ASSERT_EQ(stats.size, 5);
+    ASSERT_TRUE(are_close(result->decrypt().data(), {6, 12, 18}));
+
+    ctx->encode_cache_capacity(2);
+    ASSERT_EQ(ctx->encode_cache_stats().size, 2);
+    ctx->clear_encode_cache();
+    stats = ctx->encode_cache_stats();
+    ASSERT_EQ(stats.size, 0);
+    ASSERT_EQ(stats.hits, 0);
+    ASSERT_EQ(stats.capacity, 2);
+}
+
+TEST_P(CKKSVectorTest, TestCKKSEncodedMatMul) {
+    auto should_serialize_first = get<0>(GetParam());
+    auto enc_type = get<1>(GetParam());
+
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type);
+    ASSERT_TRUE(ctx != nullptr);
+
+    ctx->generate_galois_keys();
+    ctx->global_scale(std::pow(2, 40));
+
+    auto vec = CKKSVector::Create(ctx, std::vector<double>({1, 2, 3}));
+    auto plain = PlainTensor<double>(
+        vector<vector<double>>{{1, 2}, {3, 4}, {5, 6}});
+    auto matrix = EncodedMatrix::Create(ctx, plain);
+    ASSERT_EQ(matrix->shape(), vector<size_t>({3, 2}));
+
+    auto result = vec->matmul_plain(matrix);
+    if (should_serialize_first) {
+        result = duplicate(result);
+    }
+    auto decrypted_result = result->decrypt();
+    ASSERT_EQ(decrypted_result.size(), 2);
+    ASSERT_TRUE(are_close(decrypted_result.data(), {22, 28}));
+    ASSERT_TRUE(are_close(decrypted_result.data(),
+                          vec->matmul_plain(plain)->decrypt().data()));
+
+    // the diagonals are switched down to the level of the vector
+    auto squared = vec->square();
+    result = squared->matmul_plain(matrix);
+    ASSERT_TRUE(are_close(result->decrypt().data(), {58, 72}));
+
+    // the switched diagonals are kept until they're cleared
+    auto level = squared->ciphertext()[0].parms_id();
+    auto derived = matrix->diagonals(level);
+    ASSERT_EQ(matrix->diagonals(level), derived);
+    matrix->clear();
+    ASSERT_NE(matrix->diagonals(level), derived);
+    ASSERT_EQ(matrix->diagonals(matrix->parms_id()),
+              matrix->diagonals(matrix->parms_id()));
+
+    // the vector is switched down to the level of the matrix
+    auto lower = ctx->seal_context()->first_context_data()->next_context_data();
+    auto lower_matrix =
+        EncodedMatrix::Create(ctx, plain, std::nullopt, lower->parms_id());
+    result = vec->matmul_plain(lower_matrix);
+    ASSERT_TRUE(are_close(result->decrypt().data(), {22, 28}));
+    EXPECT_THROW(lower_matrix->diagonals(ctx->seal_context()->first_parms_id()),
+                 std::exception);
+
+    // zero diagonals are skipped
+    auto sparse = EncodedMatrix::Create(
+        ctx, PlainTensor<double>(
+                 vector<vector<double>>{{1, 0, 0}, {0, 2, 0}, {0, 0, 3}}));
+    ASSERT_EQ(sparse->indices(), vector<size_t>({0}));
+    result = vec->matmul_plain(sparse);
+    ASSERT_TRUE(are_close(result->decrypt().data(), {1, 4, 9}));
+
+    EXPECT_THROW(CKKSVector::Create(ctx, std::vector<double>({1, 2}))
+                     ->matmul_plain(matrix),
+                 std::exception);
+}
+
+TEST_P(CKKSVectorTest, TestCKKSBSGSMatMul) {
+    auto should_serialize_first = get<0>(GetParam());
+    auto enc_type = get<1>(GetParam());
+
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type);
+    ASSERT_TRUE(ctx != nullptr);
+    ctx->global_scale(std::pow(2, 40));
+
+    size_t rows = 20, cols = 6;
+    ASSERT_EQ(bsgs_baby_steps(rows), 5);
+    ASSERT_EQ(bsgs_baby_steps(15), 0);
+
+    // 4 baby steps and 3 giant steps rather than 19 steps
+    RotationPlanner planner(ctx);
+    planner.matmul_plain(rows, cols);
+    ASSERT_EQ(planner.steps(), vector<int>({1, 2, 3, 4, 5, 10, 15}));
+    planner.matmul_plain(16, 16);
+    planner.generate_galois_keys();
+
+    vector<double> input(rows);
+    vector<vector<double>> weights(rows, vector<double>(cols));
+    vector<double> expected_result(cols, 0);
+    for (size_t i = 0; i < rows; i++) {
+        input[i] = static_cast<double>(i % 5) - 2;
+        for (size_t j = 0; j < cols; j++) {
+            weights[i][j] = static_cast<double>((i * 7 + j * 3) % 11) - 5;
+            expected_result[j] += input[i] * weights[i][j];
+        }
+    }
+    auto vec = CKKSVector::Create(ctx, input);
+    auto matrix = PlainTensor<double>(weights);
+    auto result = vec->matmul_plain(matrix);
+    if (should_serialize_first) {
+        result = duplicate(result);
+    }
+    ASSERT_TRUE(are_close(result->decrypt().data(), expected_result));
+
+    auto encoded = EncodedMatrix::Create(ctx, matrix);
+    ASSERT_EQ(encoded->baby_steps(), 5);
+    ASSERT_TRUE(are_close(vec->matmul_plain(encoded)->decrypt().data(),
+                          expected_result));
+
+    // the giant steps without any nonzero diagonal are skipped
+    vector<vector<double>> diagonal(16, vector<double>(16, 0));
+    for (size_t i = 0; i < 16; i++) diagonal[i][i] = 2;
+    auto sparse = EncodedMatrix::Create(ctx, PlainTensor<double>(diagonal));
+    ASSERT_EQ(sparse->baby_steps(), 4);
+    ASSERT_EQ(sparse->indices(), vector<size_t>({0}));
+    vector<double> input16(input.begin(), input.begin() + 16);
+    vector<double> doubled(16);
+    for (size_t i = 0; i < 16; i++) doubled[i] = 2 * input16[i];
+    auto vec16 = CKKSVector::Create(ctx, input16);
+    ASSERT_TRUE(
+        are_close(vec16->matmul_plain(sparse)->decrypt().data(), doubled));
+}
+
+TEST_F(CKKSVectorTest, TestCKKSPlainOpsAtLevel) {
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60});
+    ctx->global_scale(std::pow(2, 40));
+
+    // the plain operands are encoded at the level of the ciphertext, without
+    // switching them down
+    auto vec = CKKSVector::Create(ctx, std::vector<double>({1, 2, 3}));
+    vec->square_inplace();
+    auto parms_id = vec->ciphertext()[0].parms_id();
+    ASSERT_NE(parms_id, ctx->seal_context()->first_parms_id());
+
+    vec->add_plain_inplace(1.0);
+    vec->sub_plain_inplace(PlainTensor<double>(vector<double>{1, 1, 1}));
+    vec->add_plain_inplace(PlainTensor<double>(vector<double>{1, 2, 3}));
+    ASSERT_EQ(vec->ciphertext()[0].parms_id(), parms_id);
+    ASSERT_TRUE(are_close(vec->decrypt().data(), {2, 6, 12}));
+
+    vec->mul_plain_inplace(PlainTensor<double>(vector<double>{3, 2, 1}));
+    ASSERT_TRUE(are_close(vec->decrypt().data(), {6, 12, 12}));
+
+    Plaintext plaintext;
+    ctx->encode<CKKSEncoder>(2.0, plaintext, optional<double>(), parms_id);
+    ASSERT_EQ(plaintext.parms_id(), parms_id);
+
+    // without auto_mod_switch, they're encoded at the top of the chain and
+    // SEAL rejects the mismatch
+    ctx->auto_mod_switch(false);
+    EXPECT_THROW(vec->add_plain_inplace(1.0), invalid_argument);
+    EXPECT_THROW(
+        vec->mul_plain_inplace(PlainTensor<double>(vector<double>{1, 1, 1})),
+        invalid_argument);
+}
+
+TEST_F(CKKSVectorTest, TestCKKSPolyvalDepth) {
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {40, 30, 30, 30, 30, 40});
+    ctx->global_scale(std::pow(2, 30));
+    auto seal_context = ctx->seal_context();
+    auto consumed = [&](const shared_ptr<CKKSVector>& vec) {
+        auto parms_id = vec->ciphertext()[0].parms_id();
+        return seal_context->first_context_data()->chain_index() -
+               seal_context->get_context_data(parms_id)->chain_index();
+    };
+
+    // polyval consumes the depth it's sized for, one level less for the
+    // pure powers of two left unscaled
+    auto vec = CKKSVector::Create(ctx, std::vector<double>({0.5, 1}));
+    for (size_t degree = 1; degree <= 7; degree++) {
+        vector<double> scaled(degree + 1, 0.5);
+        ASSERT_EQ(consumed(vec->polyval(scaled)), polyval_depth(degree));
+        ASSERT_EQ(polyval_depth(scaled), polyval_depth(degree));
+
+        vector<double> ones(degree + 1, 1.0);
+        ASSERT_EQ(consumed(vec->polyval(ones)), polyval_depth(ones));
+
+        vector<double> power(degree + 1, 0.0);
+        power[degree] = 1.0;
+        auto result = vec->polyval(power);
+        ASSERT_EQ(consumed(result), polyval_depth(power));
+        ASSERT_TRUE(are_close(result->decrypt().data(),
+                              {std::pow(0.5, degree), 1}));
+    }
+    ASSERT_EQ(polyval_depth(vector<double>({0, 0, 0, 0, 1})), 2);
+    ASSERT_EQ(polyval_depth(4), 3);
+}
+
 TEST_P(CKKSVectorTest, TestEmptyPlaintext) {
     auto should_serialize_first = get<0>(GetParam());
     auto enc_type = get<1>(GetParam());
@@ -308,6 +539,68 @@ TEST_F(CKKSVectorTest, TestCKKSVectorSerializationSize) {
     ASSERT_TRUE(2 * sym_buffer.size() > pk_buffer.size());
 }
 
+TEST_F(CKKSVectorTest, TestCKKSVectorSeededSerialization) {
+    auto ctx =
+        TenSEALContext::Create(scheme_type::ckks, 8192, -1, {60, 40, 40, 60},
+                               encryption_type::symmetric);
+    ctx->global_scale(std::pow(2, 40));
+    auto vec = CKKSVector::Create(ctx, vector<double>({1, 2, 3}));
+
+    // the fresh ciphertexts are saved seeded, about half their full size
+    auto buffer = vec->save();
+    auto full_size = vec->ciphertext()[0].save_size(compr_mode_type::none);
+    ASSERT_LT(buffer.size(), full_size * 6 / 10);
+
+    auto loaded = CKKSVector::Create(ctx, buffer);
+    ASSERT_TRUE(are_close(loaded->decrypt().data(), {1, 2, 3}));
+
+    // the operations on a copy leave the seeded form of the source
+    auto result = vec->add_plain(1.0);
+    ASSERT_EQ(vec->save(), buffer);
+
+    // a modified ciphertext is saved in full
+    vec->add_plain_inplace(1.0);
+    auto modified_buffer = vec->save();
+    ASSERT_GT(modified_buffer.size(), buffer.size());
+
+    loaded = CKKSVector::Create(ctx, modified_buffer);
+    ASSERT_TRUE(are_close(loaded->decrypt().data(), {2, 3, 4}));
+
+    // as are the ciphertexts replacing the encrypted ones
+    auto replaced = CKKSVector::Create(ctx, vector<double>({1, 2, 3}));
+    auto ciphertexts = result->ciphertext();
+    replaced->ciphertext(std::move(ciphertexts));
+    loaded = CKKSVector::Create(ctx, replaced->save());
+    ASSERT_TRUE(are_close(loaded->decrypt().data(), {2, 3, 4}));
+}
+
+TEST_F(CKKSVectorTest, TestCKKSEncryptSpan) {
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60});
+    ctx->global_scale(std::pow(2, 40));
+
+    Plaintext plaintext;
+    vector<double> decoded;
+    ctx->encode_replicated<CKKSEncoder>(vector<double>{1, 2, 3}, plaintext);
+    ctx->decode<CKKSEncoder>(plaintext, decoded);
+    ASSERT_EQ(decoded.size(), 4096);
+    ASSERT_TRUE(are_close(vector<double>(decoded.end() - 4, decoded.end()),
+                          {2, 3, 1, 2}));
+
+    // a view of the middle of a buffer, split over two ciphertexts
+    vector<double> buffer(6000);
+    for (size_t i = 0; i < buffer.size(); i++) buffer[i] = i % 7;
+    auto view = gsl::span<const double>(buffer).subspan(500, 5000);
+    auto vec = CKKSVector::Create(ctx, view);
+    ASSERT_EQ(vec->ciphertext().size(), 2);
+    ASSERT_EQ(vec->chunked_size(), vector<size_t>({4096, 904}));
+    ASSERT_TRUE(are_close(vec->decrypt().data(),
+                          vector<double>(view.begin(), view.end())));
+
+    EXPECT_THROW(CKKSVector::Create(ctx, gsl::span<const double>()),
+                 std::exception);
+}
+
 TEST_P(CKKSVectorTest, TestCKKSAddBigVector) {
     auto should_serialize_first = get<0>(GetParam());
     auto enc_type = get<1>(GetParam());
@@ -347,6 +640,120 @@ TEST_P(CKKSVectorTest, TestCKKSAddBigVector) {
     ASSERT_TRUE(are_close(decr.data(), expected));
 }
 
+TEST_P(CKKSVectorTest, TestCKKSAsync) {
+    auto should_serialize_first = get<0>(GetParam());
+    auto enc_type = get<1>(GetParam());
+
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type);
+    ASSERT_TRUE(ctx != nullptr);
+
+    ctx->global_scale(std::pow(2, 40));
+
+    auto l = CKKSVector::Create(ctx, std::vector<double>({1, 2, 3}));
+    auto r = CKKSVector::Create(ctx, std::vector<double>({2, 2, 2}));
+
+    if (should_serialize_first) {
+        l = duplicate(l);
+    }
+
+    // independent operations overlap on the dispatcher
+    auto add = l->add_async(r);
+    auto mul = l->mul_async(r);
+    auto plain = l->mul_plain_async(PlainTensor<double>({3, 3, 3}));
+    auto square = l->square_async();
+    auto sum = l->sum_async();
+
+    ASSERT_TRUE(are_close(add.get()->decrypt().data(), {3, 4, 5}));
+    ASSERT_TRUE(are_close(mul.get()->decrypt().data(), {2, 4, 6}));
+    ASSERT_TRUE(are_close(plain.get()->decrypt().data(), {3, 6, 9}));
+    ASSERT_TRUE(are_close(square.get()->decrypt().data(), {1, 4, 9}));
+    ASSERT_TRUE(are_close(sum.get()->decrypt().data(), {6}));
+
+    // the source tensor is left unchanged
+    ASSERT_TRUE(are_close(l->decrypt().data(), {1, 2, 3}));
+
+    auto fail = l->add_async(
+        CKKSVector::Create(ctx, std::vector<double>({1, 2, 3, 4})));
+    EXPECT_THROW(fail.get(), std::exception);
+}
+
+TEST_P(CKKSVectorTest, TestCKKSMatMulCancellation) {
+    auto enc_type = get<1>(GetParam());
+
+    auto plain = PlainTensor<double>(
+        vector<vector<double>>{{1, 2}, {3, 4}, {5, 6}});
+
+    // both the serial and the parallel reductions observe the token
+    for (size_t n_threads : {1, 4}) {
+        auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                          {60, 40, 40, 60}, enc_type,
+                                          n_threads);
+        ASSERT_TRUE(ctx != nullptr);
+
+        ctx->generate_galois_keys();
+        ctx->global_scale(std::pow(2, 40));
+
+        auto vec = CKKSVector::Create(ctx, std::vector<double>({1, 2, 3}));
+
+        sync::cancellation_token token;
+        token.cancel();
+        {
+            sync::cancellation_scope scope(token);
+            EXPECT_THROW(vec->matmul_plain(plain), sync::operation_cancelled);
+            EXPECT_THROW(EncodedMatrix::Create(ctx, plain),
+                         sync::operation_cancelled);
+        }
+
+        ASSERT_TRUE(
+            are_close(vec->matmul_plain(plain)->decrypt().data(), {22, 28}));
+    }
+}
+
+TEST_P(CKKSVectorTest, TestCKKSRotationPlanner) {
+    auto enc_type = get<1>(GetParam());
+
+    auto ctx = TenSEALContext::Create(scheme_type::ckks, 8192, -1,
+                                      {60, 40, 40, 60}, enc_type);
+    ASSERT_TRUE(ctx != nullptr);
+    ctx->global_scale(std::pow(2, 40));
+
+    RotationPlanner planner(ctx);
+    planner.sum(9).matmul_plain(3, 3).replicate_first_slot(6);
+    planner.enc_matmul_plain(4, 2);
+    ASSERT_EQ(planner.steps(), vector<int>({-4, -2, -1, 1, 2, 4, 8}));
+    ASSERT_EQ(planner.galois_elts().size(), 7);
+
+    // the planned keys are enough to run the workload
+    planner.generate_galois_keys();
+    ASSERT_EQ(ctx->galois_keys()->size(), 7);
+
+    auto l = CKKSVector::Create(
+        ctx, std::vector<double>({1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    ASSERT_TRUE(are_close(l->sum()->decrypt().data(), {45}));
+
+    auto vec = CKKSVector::Create(ctx, std::vector<double>({1, 2, 3}));
+    auto matrix = PlainTensor<double>(
+        vector<vector<double>>{{1, 2, 3}, {1, 2, 3}, {1, 2, 3}});
+    ASSERT_TRUE(
+        are_close(vec->matmul_plain(matrix)->decrypt().data(), {6, 12, 18}));
+
+    auto first = CKKSVector::Create(ctx, std::vector<double>({2}));
+    ASSERT_TRUE(are_close(first->replicate_first_slot(6)->decrypt().data(),
+                          {2, 2, 2, 2, 2, 2}));
+
+    auto windows = CKKSVector::Create(
+        ctx, std::vector<double>({1, 2, 3, 4, 5, 6, 7, 8}));
+    ASSERT_TRUE(are_close(
+        windows->enc_matmul_plain(std::vector<double>({1, 1, 1, 1}), 2)
+            ->decrypt()
+            .data(),
+        {16, 20}));
+
+    EXPECT_THROW(planner.matmul_plain(8192, 10), invalid_argument);
+    EXPECT_THROW(planner.sum(0), invalid_argument);
+}
+
 INSTANTIATE_TEST_CASE_P(
     TestCKKSVector, CKKSVectorTest,
     ::testing::Values(make_tuple(false, encryption_type::asymmetric),
@@ -1,6 +1,7 @@
 import copy
 import pickle
 import math
+import threading
 import pytest
 
 import numpy as np
@@ -1022,6 +1023,90 @@ def test_vec_plain_matrix_mul_depth2(context, vec, matrix1, matrix2, precision):
     ), "Matrix multiplication is incorrect."
 
 
+@pytest.mark.parametrize("shape", [(16, 4), (33, 10), (64, 64)])
+def test_vec_plain_matrix_mul_bsgs(context, shape, precision):
+    # matrices of 16 rows and more use the baby-step giant-step method
+    planner = ts.RotationPlanner(context)
+    planner.matmul_plain(*shape)
+    planner.generate_galois_keys()
+    assert len(planner.steps()) < shape[0] - 1
+
+    vec = np.random.uniform(-1, 1, shape[0])
+    matrix = np.random.uniform(-1, 1, shape)
+    expected = (vec @ matrix).tolist()
+    ct = ts.ckks_vector(context, vec)
+    assert _almost_equal((ct @ matrix.tolist()).decrypt(), expected, precision)
+    encoded = ts.encoded_matrix(context, matrix.tolist())
+    assert _almost_equal((ct @ encoded).decrypt(), expected, precision)
+
+
+def test_encode_cache(context, precision):
+    context.generate_galois_keys()
+    context.encode_cache_capacity = 16
+    assert context.encode_cache_capacity == 16
+
+    vec = [1, 2, 3]
+    matrix = [[1, 2, 3], [4, 5, 6], [7, 8, 9]]
+    ct = ts.ckks_vector(context, vec)
+    expected = (np.array(vec) @ np.array(matrix)).tolist()
+    for _ in range(3):
+        assert _almost_equal(
+            (ct @ matrix).decrypt(), expected, precision
+        ), "Matrix multiplication is incorrect."
+
+    stats = context.encode_cache_stats()
+    assert stats.misses == 3
+    assert stats.hits == 6
+    assert stats.size == 3
+
+    context.clear_encode_cache()
+    assert context.encode_cache_stats().size == 0
+
+
+def test_encoded_matrix(context, precision):
+    context.generate_galois_keys()
+    vec = [1, 2, 3]
+    matrix = [[1, 2], [3, 4], [5, 6]]
+    encoded = ts.encoded_matrix(context, matrix)
+    assert encoded.shape == [3, 2]
+
+    ct = ts.ckks_vector(context, vec)
+    expected = (np.array(vec) @ np.array(matrix)).tolist()
+    assert _almost_equal((ct @ encoded).decrypt(), expected, precision)
+    assert _almost_equal(ct.mm_async(encoded).result().decrypt(), expected, precision)
+
+    # the same matrix at a lower level
+    expected = (np.array(vec) ** 2 @ np.array(matrix)).tolist()
+    assert _almost_equal(ct.square().mm(encoded).decrypt(), expected, precision)
+    ct.square_()
+    ct.mm_(encoded)
+    assert _almost_equal(ct.decrypt(), expected, precision)
+
+    with pytest.raises(ValueError):
+        ts.encoded_matrix(context, vec)
+
+
+@pytest.mark.parametrize(
+    "array",
+    [
+        np.array([1.5, -2.0, 3.25]),
+        np.arange(10, dtype=np.int64),
+        np.arange(20, dtype=np.float64)[::3],
+        np.random.uniform(-10, 10, 10000),
+    ],
+)
+def test_numpy_vector(context, array, precision):
+    ckks_vec = ts.ckks_vector(context, array)
+    assert ckks_vec.size() == array.size
+    assert _almost_equal(ckks_vec.decrypt(), array.tolist(), precision)
+
+    ckks_vec = ts.ckks_vector(context, array, scale=2 ** 30)
+    assert ckks_vec.scale() == 2 ** 30
+
+    with pytest.raises(ValueError):
+        ts.ckks_vector(context, np.ones((2, 2)))
+
+
 @pytest.mark.parametrize(
     "matrix_shape, vector_size",
     [((1, 1), 1), ((2, 1), 1), ((3, 2), 2), ((4, 4), 4), ((9, 7), 7), ((16, 12), 12)],
@@ -1288,3 +1373,94 @@ def test_shape(context):
     for size in range(1, 10):
         vec = ts.ckks_vector(context, [1] * size)
         assert vec.shape == [size], "Shape of encrypted vector is incorrect."
+
+
+@pytest.mark.parametrize("n_threads", [1, 4])
+def test_async(n_threads):
+    context = parallel_context(n_threads)
+    vec = ts.ckks_vector(context, [1, 2, 3])
+    other = ts.ckks_vector(context, [2, 2, 2])
+
+    futures = [
+        vec.add_async(other),
+        vec.mul_async([3, 3, 3]),
+        vec.sub_async(1),
+        vec.square_async(),
+        vec.dot_async(other),
+        vec.polyval_async([1, 1]),
+    ]
+    expected = [[3, 4, 5], [3, 6, 9], [0, 1, 2], [1, 4, 9], [12], [2, 3, 4]]
+
+    for future, exp in zip(futures, expected):
+        result = future.result()
+        assert future.done()
+        assert isinstance(result, ts.CKKSVector)
+        assert _almost_equal(result.decrypt(), exp, 1)
+
+    # the source vector is left unchanged
+    assert _almost_equal(vec.decrypt(), [1, 2, 3], 1)
+
+
+def test_cancellation(context):
+    vec = ts.ckks_vector(context, [1, 2, 3])
+
+    token = ts.CancellationToken()
+    token.cancel()
+    assert token.cancelled
+    with token:
+        with pytest.raises(ts.OperationCancelled):
+            vec.polyval([1, 2, 3])
+        with pytest.raises(ts.OperationCancelled):
+            vec.square_async().result()
+
+    with ts.CancellationToken(timeout=0):
+        with pytest.raises(ts.OperationCancelled):
+            vec.polyval([1, 2, 3])
+
+    # operations run normally once the token is deactivated
+    assert _almost_equal(vec.polyval([1, 2, 3]).decrypt(), [6, 17, 34], 1)
+
+
+def test_cancellation_from_thread(context):
+    context.generate_galois_keys()
+    matrix = ts.plain_tensor(np.random.randn(1024, 8).tolist())
+    vec = ts.ckks_vector(context, np.random.randn(1024).tolist())
+
+    # the synchronous operations release the GIL, so the canceller runs while
+    # the multiplication is in progress
+    token = ts.CancellationToken()
+    canceller = threading.Timer(0.01, token.cancel)
+    with token:
+        canceller.start()
+        with pytest.raises(ts.OperationCancelled):
+            vec.mm(matrix)
+    canceller.join()
+    assert token.cancelled
+
+
+def test_rotation_planner(context):
+    x = np.random.randn(7, 7)
+    kernel = np.random.randn(3, 3)
+    matrix = np.random.randn(10, 4)
+    x_enc, windows_nb = ts.im2col_encoding(context, x, 3, 3, 1)
+
+    planner = ts.RotationPlanner(context)
+    planner.conv2d_im2col(3, 3, windows_nb).sum(10).matmul_plain(10, 4)
+    assert all(step != 0 for step in planner.steps())
+    assert len(planner.galois_elts()) == len(planner.steps())
+
+    # only the planned keys are generated, and they are enough for the workload
+    planner.generate_galois_keys()
+    assert context.galois_keys().data.size() == len(planner.steps())
+
+    y_enc = x_enc.conv2d_im2col(kernel.tolist(), windows_nb)
+    expected = [(x[i : i + 3, j : j + 3] * kernel).sum() for i in range(5) for j in range(5)]
+    assert _almost_equal(y_enc.decrypt(), expected, 1)
+
+    vec = np.random.randn(10)
+    vec_enc = ts.ckks_vector(context, vec.tolist())
+    assert _almost_equal(vec_enc.sum().decrypt(), [vec.sum()], 1)
+    assert _almost_equal(vec_enc.mm(matrix.tolist()).decrypt(), (vec @ matrix).tolist(), 1)
+
+    with pytest.raises(ValueError):
+        planner.sum(0)
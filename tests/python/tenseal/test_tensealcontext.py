@@ -133,3 +133,141 @@ def test_seal_context_bindings():
     new_noise_budget = decryptor.invariant_noise_budget(bfv_vec.ciphertext()[0])
 
     assert noise_budget > new_noise_budget
+
+
+def test_dispatcher_metrics():
+    context = ts.context(ts.SCHEME_TYPE.CKKS, 8192, coeff_mod_bit_sizes=[60, 40, 40, 60], n_threads=2)
+    context.global_scale = 2 ** 40
+    assert context.dispatcher_metrics().tasks_executed == []
+
+    vec = ts.ckks_vector(context, [1, 2, 3])
+    futures = [vec.square_async() for _ in range(8)]
+    for future in futures:
+        future.result()
+
+    metrics = context.dispatcher_metrics()
+    assert len(metrics.queue_depth) == 2
+    assert len(metrics.busy_time) == len(metrics.idle_time) == 2
+    assert sum(metrics.tasks_executed) + metrics.helper_tasks_executed == 8
+    assert metrics.task_duration.count() == metrics.queue_delay.count() == 8
+    assert metrics.task_duration.quantile(0.5) > 0
+
+
+@pytest.mark.parametrize(
+    "encryption_type", [ts.ENCRYPTION_TYPE.ASYMMETRIC, ts.ENCRYPTION_TYPE.SYMMETRIC]
+)
+def test_generate_galois_keys_steps(encryption_type):
+    context = ts.context(
+        ts.SCHEME_TYPE.CKKS, 8192, coeff_mod_bit_sizes=[60, 40, 40, 60], encryption_type=encryption_type
+    )
+    context.generate_galois_keys(steps=[1, 2, 4])
+    selective = context.serialize(save_galois_keys=True)
+
+    context.generate_galois_keys()
+    full = context.serialize(save_galois_keys=True)
+    assert len(selective) < len(full) / 4
+
+    loaded = ts.context_from(selective)
+    assert loaded.has_galois_keys()
+    assert loaded.galois_keys().data.size() == 3
+
+    with pytest.raises(ValueError):
+        context.generate_galois_keys(steps=[])
+
+
+@pytest.mark.parametrize(
+    "encryption_type", [ts.ENCRYPTION_TYPE.ASYMMETRIC, ts.ENCRYPTION_TYPE.SYMMETRIC]
+)
+def test_lazy_galois_keys(encryption_type):
+    context = ts.context(
+        ts.SCHEME_TYPE.CKKS, 8192, coeff_mod_bit_sizes=[60, 40, 40, 60], encryption_type=encryption_type
+    )
+    context.global_scale = 2 ** 40
+    context.lazy_galois_keys = True
+    assert context.lazy_galois_keys
+    assert not context.has_galois_keys()
+
+    vec = ts.ckks_vector(context, [1, 2, 3, 4])
+    assert abs(vec.sum().decrypt()[0] - 10) < 0.01
+    # only the steps used by the sum got a key
+    assert context.galois_keys().data.size() == 2
+
+    loaded = ts.context_from(context.serialize(save_secret_key=True, save_galois_keys=True))
+    assert loaded.lazy_galois_keys
+    assert loaded.galois_keys().data.size() == 2
+
+
+def test_galois_key_store(tmp_path):
+    context = ts.context(ts.SCHEME_TYPE.CKKS, 8192, coeff_mod_bit_sizes=[60, 40, 40, 60])
+    context.global_scale = 2 ** 40
+    context.generate_galois_keys(steps=[1, 2, 4])
+    path = str(tmp_path / "galois.keys")
+    context.store_galois_keys(path)
+    assert context.has_galois_keys()
+
+    vec = ts.ckks_vector(context, [1, 2, 3, 4])
+    assert abs(vec.sum().decrypt()[0] - 10) < 0.01
+
+    loaded = ts.context_from(context.serialize(save_secret_key=True, save_galois_keys=False))
+    assert not loaded.has_galois_keys()
+    loaded.load_galois_keys(path)
+    vec.link_context(loaded)
+    assert abs(vec.sum().decrypt()[0] - 10) < 0.01
+
+
+def test_context_registry():
+    context = ts.context(ts.SCHEME_TYPE.CKKS, 8192, coeff_mod_bit_sizes=[60, 40, 40, 60])
+    context.global_scale = 2 ** 40
+    context.generate_galois_keys(steps=[1, 2])
+    public = context.serialize(save_secret_key=False)
+
+    ts.Context.use_context_registry(True)
+    try:
+        first = ts.context_from(public)
+        second = ts.context_from(public)
+    finally:
+        ts.Context.use_context_registry(False)
+        ts.Context.clear_context_registry()
+
+    assert first.fingerprint() == second.fingerprint()
+    assert first.fingerprint() != context.fingerprint()
+
+    vec = ts.ckks_vector(context, [1, 2, 3])
+    loaded = ts.ckks_vector_from(first, vec.serialize())
+    # the vectors of equivalent contexts can be combined
+    result = loaded + ts.ckks_vector(second, [1, 1, 1])
+    result.link_context(context)
+    assert np.allclose(result.decrypt(), [2, 3, 4], atol=0.01)
+
+
+def test_select_parameters():
+    assert ts.polyval_depth(3) == 2
+    assert ts.polyval_depth([0, 0, 0, 0, 1]) == 2
+    assert ts.polyval_depth([0, 0, 0, 0, 2]) == ts.polyval_depth(4) == 3
+    params = ts.select_ckks_parameters(ts.polyval_depth(3), 20, 8)
+    assert params["poly_modulus_degree"] == 8192
+    assert params["coeff_mod_bit_sizes"] == [60, 40, 40, 60]
+
+    context = ts.context(
+        ts.SCHEME_TYPE.CKKS,
+        params["poly_modulus_degree"],
+        coeff_mod_bit_sizes=params["coeff_mod_bit_sizes"],
+    )
+    context.global_scale = params["global_scale"]
+    vec = ts.ckks_vector(context, [1, 2, 3])
+    assert abs(vec.polyval([1, 1, 1, 1]).decrypt()[2] - 40) < 0.01
+
+    params = ts.select_bfv_parameters(2, 20, 4096)
+    context = ts.context(
+        ts.SCHEME_TYPE.BFV,
+        params["poly_modulus_degree"],
+        params["plain_modulus"],
+        params["coeff_mod_bit_sizes"],
+    )
+    vec = ts.bfv_vector(context, [1, 2, 3])
+    assert (vec * vec * vec * vec).decrypt() == [1, 16, 81]
+
+    with pytest.raises(ValueError):
+        ts.select_ckks_parameters(100, 20, 8)
+    with pytest.raises(ValueError):
+        ts.select_ckks_parameters(2, 20, 8, security_level=100)